@@ -0,0 +1,344 @@
+/**
+  ******************************************************************************
+  * @file    synth_bench.c
+  * @author  Cullen Sharp
+  * @brief   This file provides the host benchmark of the Synth render path.
+  *          The public API renders into a block buffer that goes out through
+  *          a mock SYNTH_IO_t, whose Transmit only takes a timestamp, for a
+  *          range of voice counts and stage combinations. Throughput is
+  *          reported in samples per channel per second, then the
+  *          SYNTH_Benchmark stage timer splits it into envelope, oscillator
+  *          and output time. Build one binary per block size with make.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2025
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "synth.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define BENCH_RATE          48000U
+#define BENCH_SECONDS       4U
+#define BENCH_FRAMES        (BENCH_RATE * BENCH_SECONDS)  /*!< Rendered per run */
+#define BENCH_CASES         (sizeof(BenchCases) / sizeof(BenchCases[0]))
+#define BENCH_COUNTS        (sizeof(BenchVoices) / sizeof(BenchVoices[0]))
+
+/* Private types -------------------------------------------------------------*/
+/**
+  * @brief  Stage combination under test
+  */
+typedef struct
+{
+  const char *Name;
+  uint8_t    Waveform;
+  uint8_t    Filter;      /*!< Voice and master low-pass                   */
+  uint8_t    Fx;          /*!< Delay, chorus and reverb                    */
+  uint8_t    Clips;       /*!< SYNTH_MAX_CLIPS clips mixed with the voices */
+} BENCH_Case_t;
+
+/* Private variables ---------------------------------------------------------*/
+static const BENCH_Case_t BenchCases[] =
+{
+  { "sine",   SYNTH_WAVEFORM_SINE,   0, 0, 0 },
+  { "saw_bl", SYNTH_WAVEFORM_SAW_BL, 0, 0, 0 },
+  { "filter", SYNTH_WAVEFORM_SAW_BL, 1, 0, 0 },
+  { "fx",     SYNTH_WAVEFORM_SAW_BL, 0, 1, 0 },
+  { "clips",  SYNTH_WAVEFORM_SINE,   0, 0, 1 },
+};
+
+static const uint8_t BenchVoices[] = { 1U, 4U, 8U, 16U, SYNTH_MAX_VOICES };
+
+static SYNTH_Object_t BenchSynth;
+static SYNTH_Sample_t BenchBlock[SYNTH_STREAM_BLOCK_SIZE * SYNTH_CHANNELS];
+static SYNTH_Sample_t BenchClip[BENCH_FRAMES * SYNTH_CHANNELS];
+static uint8_t        BenchBulk[96U * SYNTH_BULK_BLOCK_SIZE] __attribute__((aligned(8)));
+
+/* Mock transmit timestamps */
+static uint64_t BenchTxFirst;
+static uint64_t BenchTxLast;
+static uint32_t BenchTxCount;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint64_t BENCH_Now(void);
+static int32_t  BENCH_IoInit(void);
+static int32_t  BENCH_Transmit(uint8_t *pData, uint32_t size);
+static int32_t  BENCH_Setup(const BENCH_Case_t *bench);
+static void     BENCH_Teardown(const BENCH_Case_t *bench);
+static double   BENCH_Run(const BENCH_Case_t *bench, uint8_t voices);
+static void     BENCH_Stages(uint8_t waveform_id, const char *name);
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  Free-running nanosecond counter standing in for the DWT
+  * @retval Nanoseconds, wraps every 4.3 s
+  */
+uint32_t BENCH_Cycles(void)
+{
+  return (uint32_t)BENCH_Now();
+}
+
+/**
+  * @brief  Sweep voice counts and stages for the configured block size
+  * @retval 0 on success
+  */
+int main(void)
+{
+  SYNTH_IO_t io;
+  uint32_t   c;
+  uint32_t   v;
+  uint32_t   i;
+  double     rate;
+
+  memset(&io, 0, sizeof(io));
+  io.Init     = BENCH_IoInit;
+  io.Transmit = BENCH_Transmit;
+
+  /* Full-scale noise so clips cost the same as real material */
+  for (i = 0; i < (BENCH_FRAMES * SYNTH_CHANNELS); i++)
+  {
+    BenchClip[i] = (SYNTH_Sample_t)((int32_t)((i * 2654435761UL) >> 16) - 32768);
+  }
+
+  if ((SYNTH_RegisterBusIO(&BenchSynth, &io) != SYNTH_STATUS_OK) ||
+      (SYNTH_RegisterBulkPool(&BenchSynth, BenchBulk, sizeof(BenchBulk)) != SYNTH_STATUS_OK))
+  {
+    return 1;
+  }
+
+  printf("block %u frames, %u Hz, %u channels\n",
+         (unsigned)SYNTH_STREAM_BLOCK_SIZE, (unsigned)BENCH_RATE, (unsigned)SYNTH_CHANNELS);
+  printf("%-8s %6s %12s %10s\n", "case", "voices", "Msamples/s", "realtime");
+
+  for (c = 0; c < BENCH_CASES; c++)
+  {
+    for (v = 0; v < BENCH_COUNTS; v++)
+    {
+      rate = BENCH_Run(&BenchCases[c], BenchVoices[v]);
+      if (rate <= 0.0)
+      {
+        printf("%-8s %6u %12s\n", BenchCases[c].Name, (unsigned)BenchVoices[v], "failed");
+        continue;
+      }
+
+      printf("%-8s %6u %12.2f %9.1fx\n", BenchCases[c].Name, (unsigned)BenchVoices[v],
+             rate / 1.0e6, rate / (double)BENCH_RATE);
+    }
+  }
+
+  printf("\n%-8s %6s %10s %10s %10s\n", "stages", "voices", "env ns/s", "osc ns/s", "out ns/s");
+  BENCH_Stages(SYNTH_WAVEFORM_SINE, "sine");
+  BENCH_Stages(SYNTH_WAVEFORM_SAW_BL, "saw_bl");
+
+  return 0;
+}
+
+/* Private functions ---------------------------------------------------------*/
+/**
+  * @brief  Monotonic time
+  * @retval Nanoseconds
+  */
+static uint64_t BENCH_Now(void)
+{
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+  * @brief  Mock bus initialization
+  * @retval 0
+  */
+static int32_t BENCH_IoInit(void)
+{
+  return 0;
+}
+
+/**
+  * @brief  Mock blocking transmit, only records when the block was ready
+  * @param  pData  Unused
+  * @param  size   Unused
+  * @retval 0
+  */
+static int32_t BENCH_Transmit(uint8_t *pData, uint32_t size)
+{
+  uint64_t now = BENCH_Now();
+
+  (void)pData;
+  (void)size;
+
+  if (BenchTxCount == 0U)
+  {
+    BenchTxFirst = now;
+  }
+  BenchTxLast = now;
+  BenchTxCount++;
+
+  return 0;
+}
+
+/**
+  * @brief  Initialize the Synth and enable the stages of a case
+  * @param  bench  Pointer to case
+  * @retval Synth status
+  */
+static int32_t BENCH_Setup(const BENCH_Case_t *bench)
+{
+  /* Held notes, so the voice count stays fixed over the run */
+  SYNTH_Envelope_t envelope = { 5U, 100U, 200U, 100U };
+  SYNTH_Filter_t   filter   = { 1U, 24, 40U };
+  SYNTH_Delay_t    delay    = { 1U, 250U, 50U, 30U };
+  SYNTH_Chorus_t   chorus   = { 1U, 10U, 30U, 30U };
+  SYNTH_Reverb_t   reverb   = { 1U, 80U, 30U, 30U };
+  int32_t status;
+  uint32_t c;
+
+  status = SYNTH_Init(&BenchSynth, BENCH_RATE, SYNTH_CHANNELS);
+  status |= SYNTH_SetVolume(&BenchSynth, 80U);
+  status |= SYNTH_SetEnvelope(&BenchSynth, &envelope);
+  status |= SYNTH_SetWaveform(&BenchSynth, bench->Waveform);
+
+  if (bench->Filter)
+  {
+    status |= SYNTH_SetFilter(&BenchSynth, SYNTH_FILTER_VOICE, &filter);
+    filter.Cutoff = 90;
+    status |= SYNTH_SetFilter(&BenchSynth, SYNTH_FILTER_MASTER, &filter);
+  }
+
+  if (bench->Fx)
+  {
+    status |= SYNTH_SetDelay(&BenchSynth, &delay);
+    status |= SYNTH_SetChorus(&BenchSynth, &chorus);
+    status |= SYNTH_SetReverb(&BenchSynth, &reverb);
+  }
+
+  if (bench->Clips)
+  {
+    for (c = 0; c < SYNTH_MAX_CLIPS; c++)
+    {
+      status |= SYNTH_QueueBuffer(&BenchSynth, BenchClip, BENCH_FRAMES * SYNTH_CHANNELS,
+                                  50U, NULL);
+    }
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Hand the delay lines back and shut the Synth down
+  * @param  bench  Pointer to case
+  * @retval None
+  */
+static void BENCH_Teardown(const BENCH_Case_t *bench)
+{
+  SYNTH_Delay_t  delay;
+  SYNTH_Chorus_t chorus;
+  SYNTH_Reverb_t reverb;
+
+  if (bench->Fx)
+  {
+    memset(&delay, 0, sizeof(delay));
+    memset(&chorus, 0, sizeof(chorus));
+    memset(&reverb, 0, sizeof(reverb));
+    (void)SYNTH_SetDelay(&BenchSynth, &delay);
+    (void)SYNTH_SetChorus(&BenchSynth, &chorus);
+    (void)SYNTH_SetReverb(&BenchSynth, &reverb);
+  }
+
+  (void)SYNTH_DeInit(&BenchSynth);
+}
+
+/**
+  * @brief  Render BENCH_SECONDS through SYNTH_Render and SYNTH_PlayBuffer
+  * @note   The time between the first and last transmit covers the blocks
+  *         rendered in between, so setup and note starts stay out.
+  * @param  bench   Pointer to case
+  * @param  voices  Held notes
+  * @retval Samples per channel per second, 0 on failure
+  */
+static double BENCH_Run(const BENCH_Case_t *bench, uint8_t voices)
+{
+  uint32_t frames;
+  uint32_t i;
+  double   elapsed;
+
+  if (BENCH_Setup(bench) != SYNTH_STATUS_OK)
+  {
+    BENCH_Teardown(bench);
+    return 0.0;
+  }
+
+  for (i = 0; i < voices; i++)
+  {
+    (void)SYNTH_NoteOn(&BenchSynth, (uint8_t)(24U + (i * 3U)), 100U);
+  }
+
+  BenchTxCount = 0;
+  for (frames = 0; frames < BENCH_FRAMES; frames += SYNTH_STREAM_BLOCK_SIZE)
+  {
+    (void)SYNTH_Render(&BenchSynth, BenchBlock, SYNTH_STREAM_BLOCK_SIZE * SYNTH_CHANNELS);
+    if (SYNTH_PlayBuffer(&BenchSynth, BenchBlock,
+                         SYNTH_STREAM_BLOCK_SIZE * SYNTH_CHANNELS) != SYNTH_STATUS_OK)
+    {
+      BENCH_Teardown(bench);
+      return 0.0;
+    }
+  }
+
+  BENCH_Teardown(bench);
+
+  elapsed = (double)(BenchTxLast - BenchTxFirst) * 1.0e-9;
+  if ((BenchTxCount < 2U) || (elapsed <= 0.0))
+  {
+    return 0.0;
+  }
+
+  return (double)(BenchTxCount - 1U) * SYNTH_STREAM_BLOCK_SIZE / elapsed;
+}
+
+/**
+  * @brief  Split one waveform's cost into stages with SYNTH_Benchmark
+  * @param  waveform_id  Oscillator under test
+  * @param  name         Label
+  * @retval None
+  */
+static void BENCH_Stages(uint8_t waveform_id, const char *name)
+{
+  SYNTH_Bench_t result;
+  uint32_t v;
+  double   frames;
+
+  for (v = 0; v < BENCH_COUNTS; v++)
+  {
+    if ((SYNTH_Init(&BenchSynth, BENCH_RATE, SYNTH_CHANNELS) != SYNTH_STATUS_OK) ||
+        (SYNTH_Benchmark(&BenchSynth, waveform_id, BenchVoices[v],
+                         BENCH_FRAMES / SYNTH_STREAM_BLOCK_SIZE, &result) != SYNTH_STATUS_OK))
+    {
+      printf("%-8s %6u %10s\n", name, (unsigned)BenchVoices[v], "failed");
+      continue;
+    }
+
+    /* Nanoseconds per second of output, per stage */
+    frames = (double)result.Frames / (double)BENCH_RATE;
+    printf("%-8s %6u %10.0f %10.0f %10.0f\n", name, (unsigned)BenchVoices[v],
+           (double)result.EnvelopeCycles / frames, (double)result.OscillatorCycles / frames,
+           (double)result.OutputCycles / frames);
+    (void)SYNTH_DeInit(&BenchSynth);
+  }
+}
+
+/************************ (C) COPYRIGHT Embedded Systems Team *****END OF FILE****/
@@ -0,0 +1,178 @@
+/**
+  ******************************************************************************
+  * @file    synth_conf.h
+  * @author  Cullen Sharp
+  * @brief   This file contains the Synth configuration of the host
+  *          benchmark: every stage built in, cycles from a nanosecond clock.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2025
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef SYNTH_CONF_H
+#define SYNTH_CONF_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/** @addtogroup Components
+  * @{
+  */
+
+/** @addtogroup Synth
+  * @{
+  */
+
+/** @defgroup SYNTH_Configuration Synth Configuration
+  * @{
+  */
+
+/* Output format. Loops over channels and samples use these as constants,
+   so only the selected path is compiled in. */
+#define SYNTH_CHANNELS                2U       /*!< Interleaved channels, 1 or 2    */
+#define SYNTH_SAMPLE_BITS             16U      /*!< 16, 24 (in 32) or 32            */
+
+/* Render block: frames per DMA half-buffer and per mixer pass. The
+   Makefile builds one benchmark per block size. */
+#ifndef SYNTH_STREAM_BLOCK_SIZE
+#define SYNTH_STREAM_BLOCK_SIZE       256U
+#endif
+
+/* Voice engine */
+#define SYNTH_MAX_VOICES              32U      /*!< Voice pool size (8/16/32)        */
+#define SYNTH_MIX_HEADROOM_SHIFT      2U       /*!< Mix bus attenuation, 6 dB/step  */
+#define SYNTH_VOICE_STEAL_POLICY      SYNTH_STEAL_OLDEST
+#define SYNTH_EVENT_QUEUE_SIZE        32U      /*!< Event slots, power of two       */
+#define SYNTH_MAX_CLIPS               4U       /*!< PCM clips mixed with the voices */
+
+/* Oscillators */
+#define SYNTH_WAVETABLE_INTERPOLATION 1U       /*!< Linear interpolation 0/1        */
+#define SYNTH_MAX_USER_WAVETABLES     4U       /*!< User-loadable table slots       */
+
+/* Dual-core render split (STM32H747): the second core renders the odd
+   voice slots into a sub-mix. The object, pools and wavetables must sit in
+   memory both cores reach and non-cacheable on the CM7 (MPU region), as
+   both cores write voice state. SYNTH_HSEM_NOTIFY wakes the CM4,
+   e.g. HAL_HSEM_FastTake(id); HAL_HSEM_Release(id, 0U), and the CM4
+   HAL_HSEM_FreeCallback calls SYNTH_RenderSecondary. */
+#define SYNTH_USE_DUAL_CORE           0U
+#define SYNTH_HSEM_RENDER             0U       /*!< HSEM id raising the CM4 interrupt */
+#define SYNTH_HSEM_NOTIFY(id)         do { (void)(id); } while (0)
+#define SYNTH_DUAL_CORE_TIMEOUT       100000U  /*!< Sub-mix wait, polling loops    */
+
+/* FreeRTOS render task: the DMA interrupt only releases stream halves and
+   notifies a task at SYNTH_RTOS_PRIORITY, which applies queued commands
+   and renders. Needs configSUPPORT_STATIC_ALLOCATION; keep the DMA IRQ at
+   or below configMAX_SYSCALL_INTERRUPT_PRIORITY. */
+#define SYNTH_USE_RTOS                0U
+#define SYNTH_RTOS_PRIORITY           (configMAX_PRIORITIES - 1U)
+#define SYNTH_RTOS_STACK_SIZE         512U     /*!< Render task stack, words        */
+#define SYNTH_RTOS_QUEUE_LENGTH       16U      /*!< Commands waiting for the task   */
+
+/* Block-rate modulation: LFOs and modulation matrix entries, 0 LFOs to
+   leave it out */
+#define SYNTH_MAX_LFOS                2U
+#define SYNTH_MOD_SLOTS               4U
+
+/* Sampler slots playing PCM in place from flash or XIP memory, 0 to leave
+   them out. SYNTH_SAMPLER_CACHE copies each slot's loop, or its start if
+   the loop does not fit, into one pool block of SRAM. */
+#define SYNTH_MAX_SAMPLERS            4U
+#define SYNTH_SAMPLER_CACHE           1U
+
+/* USB Audio input: the OUT endpoint receives straight into a ring through
+   SYNTH_AcquireUsbBuffer/SYNTH_CommitUsbBuffer, the render pass mixes it
+   on the clip bus at the output rate and SYNTH_GetUsbFeedback turns the
+   ring fill into the asynchronous feedback endpoint value. */
+#define SYNTH_USE_USB_INPUT           0U
+#define SYNTH_USB_RING_FRAMES         1024U    /*!< Ring capacity, latency is half  */
+#define SYNTH_USB_PACKET_FRAMES       49U      /*!< Largest OUT packet, rate/1000+1 */
+#define SYNTH_USB_FEEDBACK_FORMAT     SYNTH_USB_FEEDBACK_10_14
+
+/* Resonant low-pass biquad per voice and on the master bus, 0 to leave
+   it out. SYNTH_USE_CMSIS_DSP runs it through arm_biquad_cascade_df1_q31. */
+#define SYNTH_USE_FILTER              1U
+#define SYNTH_USE_CMSIS_DSP           0U
+
+/* What a stream half plays when SYNTH_CommitBuffer comes too late */
+#define SYNTH_UNDERRUN_FILL           SYNTH_UNDERRUN_SILENCE
+
+/* PlayBuffer data at another rate than the output is converted with a
+   fixed-point cubic interpolator, 0 to leave it out */
+#define SYNTH_USE_RESAMPLER           1U
+
+/* DMA buffer placement and cache maintenance. On Cortex-M7 define
+   SYNTH_DCACHE_CLEAN as SCB_CleanDCache_by_Addr((uint32_t *)(addr), (int32_t)(size)) */
+#define SYNTH_DMA_ALIGN               __attribute__((aligned(32)))
+#define SYNTH_DCACHE_CLEAN(addr, size)  do { (void)(addr); (void)(size); } while (0)
+
+/* Memory pool: block size for SYNTH_RegisterPool and placement attributes
+   for the arrays handed to it. On STM32H7 e.g.
+   __attribute__((section(".dtcmram"))) for SYNTH_FAST_RAM (state touched
+   every sample) and __attribute__((section(".sdram"))) for SYNTH_BULK_RAM
+   (delay lines). DTCM is not reachable by DMA1/2, keep stream memory out. */
+#define SYNTH_POOL_BLOCK_SIZE         512U     /*!< Bytes per pool block            */
+#define SYNTH_FAST_RAM
+#define SYNTH_BULK_RAM
+
+/* Master effects after the mixer, each 0 to leave it out. Their delay
+   lines chain SYNTH_BULK_BLOCK_SIZE blocks from SYNTH_RegisterBulkPool, so
+   an SDRAM array works; taps move a block at a time. */
+#define SYNTH_USE_DELAY               1U
+#define SYNTH_USE_CHORUS              1U
+#define SYNTH_USE_REVERB              1U
+#define SYNTH_BULK_BLOCK_SIZE         4096U    /*!< Bytes per delay line segment    */
+#define SYNTH_FX_MAX_SEGMENTS         32U      /*!< Segments per delay line         */
+
+/* Profiling counters and the SYNTH_Benchmark stage timer, in host
+   nanoseconds from BENCH_Cycles */
+#define SYNTH_USE_STATS               1U
+#define SYNTH_CYCLE_COUNT()           BENCH_Cycles()
+
+extern uint32_t BENCH_Cycles(void);
+
+/* Uncomment to force the DSP instruction path on or off, by default it
+   follows __ARM_FEATURE_DSP */
+/* #define SYNTH_USE_DSP              1U */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYNTH_CONF_H */
+
+/************************ (C) COPYRIGHT Embedded Systems Team *****END OF FILE****/
@@ -19,7 +19,10 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "synth.h"
+#include "synth_wavetable.h"
+#include "synth_dsp.h"
 #include <string.h>  /* For memset */
+#include <math.h>    /* For expf, coefficient setup only */
 
 /** @addtogroup BSP
   * @{
@@ -33,32 +36,347 @@
   * @{
   */
 
+/** @defgroup SYNTH_Exported_Variables Synth Exported Variables
+  * @{
+  */
+
+SYNTH_Drv_t SYNTH_Driver =
+{
+  SYNTH_Init,
+  SYNTH_DeInit,
+  SYNTH_Reset,
+  SYNTH_SetSampleRate,
+  SYNTH_GetSampleRate,
+  SYNTH_PlayBuffer,
+  SYNTH_Stop,
+  SYNTH_Pause,
+  SYNTH_Resume,
+  SYNTH_SetVolume,
+  SYNTH_GetVolume,
+  SYNTH_Mute,
+  SYNTH_SetWaveform,
+  SYNTH_SetFrequency,
+  SYNTH_NoteOn,
+  SYNTH_NoteOff
+};
+
+/**
+  * @}
+  */
+
+/* Private macros ------------------------------------------------------------*/
+/* Orders event queue slot accesses against the index update. A data memory
+   barrier on Arm, a compiler barrier elsewhere (host builds). */
+#if defined(__ARM_ARCH)
+#define SYNTH_MEMORY_BARRIER()  __asm volatile ("dmb" ::: "memory")
+#else
+#define SYNTH_MEMORY_BARRIER()  __asm volatile ("" ::: "memory")
+#endif
+
+/* Dirty bits are raised by setters and taken by the render pass, which may
+   preempt each other. Both sides are single atomic read-modify-writes
+   (LDREXB/STREXB on Armv7-M) so a bit raised in between is never lost;
+   raising also orders the new setting before the bit. */
+#define SYNTH_DIRTY_RAISE(p, bits)  \
+  ((void)__atomic_fetch_or(&(p)->Dirty, (uint8_t)(bits), __ATOMIC_RELEASE))
+#define SYNTH_DIRTY_TAKE(p)         __atomic_exchange_n(&(p)->Dirty, (uint8_t)0U, __ATOMIC_ACQUIRE)
+
+/* Stream half bits (StreamFree, StreamLate, StreamSilent) are changed both
+   from the DMA interrupt and from the context filling the stream, so every
+   change is one atomic read-modify-write as well. */
+#define SYNTH_BITS_SET(var, bits)   \
+  ((void)__atomic_fetch_or(&(var), (uint8_t)(bits), __ATOMIC_ACQ_REL))
+#define SYNTH_BITS_CLEAR(var, bits) \
+  ((void)__atomic_fetch_and(&(var), (uint8_t)~(uint8_t)(bits), __ATOMIC_ACQ_REL))
+
+/* Extra fractional bits kept in the mix accumulator for wide output. The
+   SMLAWB level operand grows by the same amount, so a 24/32-bit build
+   keeps 8 bits below the int16_t wavetable LSB. */
+#if (SYNTH_SAMPLE_BITS == 16U)
+#define SYNTH_MIX_EXTRA_BITS    0U
+#else
+#define SYNTH_MIX_EXTRA_BITS    8U
+#endif
+
+/* Q30 envelope level to the SMLAWB operand, Q16 plus the extra bits */
+#define SYNTH_LEVEL_SHIFT       (14U - SYNTH_MIX_EXTRA_BITS)
+
+/* Accumulator times Q15 gain down to the output sample width */
+#define SYNTH_OUTPUT_SHIFT      (15U + SYNTH_MIX_HEADROOM_SHIFT + SYNTH_MIX_EXTRA_BITS - \
+                                 (SYNTH_SAMPLE_BITS - 16U))
+
+/* Profiling hooks, compiled out unless SYNTH_USE_STATS is set. The DWT is
+   reached through its architectural addresses so no device header is
+   needed, the lock access register only exists on Cortex-M7. Other
+   targets must supply their own counter. */
+#if (SYNTH_USE_STATS == 1U)
+#ifndef SYNTH_CYCLE_COUNT
+#if !defined(__ARM_ARCH)
+#error "SYNTH_USE_STATS needs SYNTH_CYCLE_COUNT on a target without a DWT"
+#endif
+#define SYNTH_CYCLE_COUNT()     (*(volatile uint32_t *)0xE0001004UL)
+#define SYNTH_CYCLE_INIT()      do {                                                  \
+                                  *(volatile uint32_t *)0xE000EDFCUL |= (1UL << 24);  \
+                                  *(volatile uint32_t *)0xE0001FB0UL  = 0xC5ACCE55UL; \
+                                  *(volatile uint32_t *)0xE0001000UL |= 1UL;          \
+                                } while (0)
+#else
+#define SYNTH_CYCLE_INIT()      do { } while (0)
+#endif
+#define SYNTH_STATS_INC(p, f)   ((p)->Stats.f++)
+#else
+#define SYNTH_STATS_INC(p, f)   do { } while (0)
+#endif
+
+/* Output scale sample times Q15 clip gain down to mix accumulator units */
+#define SYNTH_CLIP_SHIFT        (SYNTH_SAMPLE_BITS - 1U - SYNTH_MIX_HEADROOM_SHIFT - \
+                                 SYNTH_MIX_EXTRA_BITS)
+
+/* Scratch block for filtered voices of the first core */
+#if (SYNTH_USE_FILTER == 1U)
+#define SYNTH_VOICE_SCRATCH(p)      ((p)->VoiceBuffer)
+#else
+#define SYNTH_VOICE_SCRATCH(p)      NULL
+#endif
+
+/* The voice pool is free to touch: no block is outstanding on the second core */
+#if (SYNTH_USE_DUAL_CORE == 1U)
+#define SYNTH_VOICES_OWNED(p)       ((p)->SubDone == (p)->SubRequest)
+#else
+#define SYNTH_VOICES_OWNED(p)       1U
+#endif
+
+/* Cutoff offset from the modulation matrix, in semitones */
+#if (SYNTH_MAX_LFOS > 0U)
+#define SYNTH_MOD_CUTOFF_OFFSET(p)  ((p)->ModCutoff)
+#else
+#define SYNTH_MOD_CUTOFF_OFFSET(p)  0
+#endif
+
+/* Derived object state recomputed at the next block boundary only when
+   an input changed, see SYNTH_RefreshBlock */
+#define SYNTH_DIRTY_GAIN            0x01U    /*!< GainTarget: volume, mute, rate change */
+#define SYNTH_DIRTY_VOICE_FILTER    0x02U    /*!< Every sounding voice's coefficients   */
+#define SYNTH_DIRTY_MASTER_FILTER   0x04U
+#define SYNTH_DIRTY_ALL             0x07U
+
+/* Derived voice state recomputed before the voice next renders, see
+   SYNTH_RefreshVoice */
+#define SYNTH_VOICE_DIRTY_PITCH     0x01U    /*!< PhaseInc from BaseInc and modulation */
+#define SYNTH_VOICE_DIRTY_FILTER    0x02U    /*!< Coefficients from note and cutoff    */
+
+/* Exponential envelope segments settle within -78 dB (Q30) of their target */
+#define SYNTH_ENV_SILENCE       ((int32_t)(1UL << 17))
+
+/* The preset image is a storage format, its layout must not drift */
+typedef char SYNTH_PresetSizeCheck[(sizeof(SYNTH_Preset_t) == 32U) ? 1 : -1];
+
 /* Private variables ---------------------------------------------------------*/
-static SYNTH_IO_t SynthIO;
-static SYNTH_Ctx_t SynthCtx;
+/* Built-in oscillator tables copied into each object on Init. Band-limited
+   waveforms are computed, their slots only point at the naive shape. */
+static const int16_t * const SynthBuiltinTables[SYNTH_WAVEFORM_USER] =
+{
+  SYNTH_SineTable, SYNTH_SquareTable, SYNTH_SawTable, SYNTH_TriangleTable,
+  SYNTH_SawTable, SYNTH_SquareTable
+};
+
+/* Volume (0-100) to Q15 gain, 0.6 dB per step down to -60 dB, 0 is silent */
+static const int16_t SynthVolumeTable[101] =
+{
+      0,    35,    38,    40,    43,    46,    50,    53,    57,    61,
+     65,    70,    75,    80,    86,    92,    99,   106,   114,   122,
+    130,   140,   150,   160,   172,   184,   197,   212,   227,   243,
+    260,   279,   299,   320,   343,   368,   394,   422,   452,   485,
+    519,   556,   596,   639,   685,   734,   786,   842,   902,   967,
+   1036,  1110,  1190,  1275,  1366,  1464,  1568,  1680,  1801,  1929,
+   2067,  2215,  2374,  2544,  2725,  2920,  3129,  3353,  3593,  3850,
+   4125,  4420,  4736,  5075,  5438,  5827,  6244,  6690,  7169,  7681,
+   8231,  8819,  9450, 10126, 10850, 11626, 12458, 13349, 14303, 15326,
+  16422, 17597, 18855, 20204, 21649, 23197, 24856, 26634, 28539, 30580,
+  32767
+};
+
+/* Frequencies of MIDI octave 4 (C4 to B4) */
+static const float SynthOctaveFreq[12] =
+{
+  261.6255653f, 277.1826310f, 293.6647679f, 311.1269837f, 329.6275569f, 349.2282314f,
+  369.9944227f, 391.9954360f, 415.3046976f, 440.0000000f, 466.1637615f, 493.8833013f
+};
 
 /* Private function prototypes -----------------------------------------------*/
 static int32_t SYNTH_DefaultTransmit(uint8_t *pData, uint32_t size);
+static int32_t SYNTH_PlayScaled(SYNTH_Object_t *pSynth, const SYNTH_Sample_t *buffer,
+                                uint32_t length);
+static void    SYNTH_StreamRefill(SYNTH_Object_t *pSynth, uint32_t index);
+static void    SYNTH_StreamSubstitute(SYNTH_Object_t *pSynth, uint32_t index);
+static int32_t SYNTH_TargetGain(SYNTH_Object_t *pSynth);
+static void    SYNTH_ApplySampleRate(SYNTH_Object_t *pSynth, uint32_t sample_rate);
+static void    SYNTH_UpdatePhaseIncs(SYNTH_Object_t *pSynth);
+static void    SYNTH_UpdateEnvelope(SYNTH_Object_t *pSynth);
+static void    SYNTH_ApplyPreset(SYNTH_Object_t *pSynth);
+#if (SYNTH_USE_FILTER == 1U)
+static void    SYNTH_UpdateFilterTable(SYNTH_Object_t *pSynth);
+static void    SYNTH_FilterCoeffs(SYNTH_Object_t *pSynth, int32_t note, int32_t damp,
+                                  int32_t *coeffs);
+#endif
+static void    SYNTH_EnvelopeBlock(SYNTH_Object_t *pSynth, SYNTH_Voice_t *voice,
+                                    uint32_t frames);
+static int32_t SYNTH_PowQ30(int32_t coef, uint32_t n);
+static uint32_t SYNTH_FrequencyToPhaseInc(SYNTH_Object_t *pSynth, float frequency);
+static uint32_t SYNTH_NoteToPhaseInc(SYNTH_Object_t *pSynth, uint8_t note);
+static SYNTH_Voice_t *SYNTH_AllocVoice(SYNTH_Object_t *pSynth, uint8_t note);
+static uint8_t SYNTH_WaveformLoaded(SYNTH_Object_t *pSynth, uint8_t waveform_id);
+static inline int32_t SYNTH_SatSample(int64_t x);
+static inline int32_t SYNTH_ScaleSample(int32_t x, int32_t gain);
+static void    SYNTH_OutputBlock(SYNTH_Object_t *pSynth, SYNTH_Sample_t *buffer, uint32_t frames);
+static uint8_t SYNTH_IsSilent(SYNTH_Object_t *pSynth, uint32_t frames);
+static uint32_t SYNTH_StreamHalfMask(SYNTH_Object_t *pSynth, const SYNTH_Sample_t *buffer);
+static void    SYNTH_RenderBlock(SYNTH_Object_t *pSynth, uint32_t frames);
+static void    SYNTH_RenderVoices(SYNTH_Object_t *pSynth, int32_t *mix, int32_t *scratch,
+                                  uint32_t frames, uint32_t first, uint32_t stride);
+static void    SYNTH_PrepareVoices(SYNTH_Object_t *pSynth, uint32_t frames, uint8_t dirty,
+                                   uint32_t first, uint32_t stride);
+#if (SYNTH_USE_DUAL_CORE == 1U)
+static void    SYNTH_RenderDual(SYNTH_Object_t *pSynth, uint32_t frames, uint8_t dirty);
+#endif
+static void    SYNTH_ApplyEvent(SYNTH_Object_t *pSynth, const SYNTH_Event_t *event,
+                                 uint32_t frames);
+static void    SYNTH_SetVoiceInc(SYNTH_Voice_t *voice, uint32_t inc);
+static void    SYNTH_TuneVoice(SYNTH_Voice_t *voice, uint32_t ratio);
+static uint8_t SYNTH_RefreshBlock(SYNTH_Object_t *pSynth);
+static void    SYNTH_RefreshVoice(SYNTH_Object_t *pSynth, SYNTH_Voice_t *voice);
+#if (SYNTH_MAX_LFOS > 0U)
+static uint8_t SYNTH_ModulateBlock(SYNTH_Object_t *pSynth, uint32_t frames);
+static void    SYNTH_UpdateLfoIncs(SYNTH_Object_t *pSynth);
+#endif
+static int32_t SYNTH_PolyBlep(uint32_t t, uint32_t dt, uint32_t recip);
+static void    SYNTH_RenderVoice(SYNTH_Voice_t *voice, int32_t *mix, uint32_t frames);
+static void    SYNTH_RenderBlepVoice(SYNTH_Voice_t *voice, int32_t *mix, uint32_t frames);
+#if (SYNTH_MAX_SAMPLERS > 0U)
+static void    SYNTH_RenderSampleVoice(SYNTH_Voice_t *voice, int32_t *mix, uint32_t frames);
+static inline int32_t SYNTH_SamplerTap(const SYNTH_SamplerSlot_t *slot, const int16_t *data,
+                                       uint32_t frame);
+#endif
+#if (SYNTH_MAX_CLIPS > 0U)
+static uint8_t SYNTH_MixClips(SYNTH_Object_t *pSynth, uint32_t frames);
+#endif
+#if (SYNTH_USE_USB_INPUT == 1U)
+static uint8_t SYNTH_MixUsb(SYNTH_Object_t *pSynth, uint32_t frames, uint8_t mixed);
+#endif
+#if (SYNTH_USE_RTOS == 1U)
+static void    SYNTH_RenderTask(void *arg);
+static void    SYNTH_ApplyCommand(SYNTH_Object_t *pSynth, const SYNTH_Command_t *command);
+static void    SYNTH_RenderTaskNotify(SYNTH_Object_t *pSynth);
+#endif
+#if (SYNTH_USE_STATS == 1U)
+static void    SYNTH_StatsRecord(uint32_t *last, uint32_t *max, uint32_t cycles);
+#endif
+#if (SYNTH_USE_RESAMPLER == 1U)
+static int32_t SYNTH_PlayResampled(SYNTH_Object_t *pSynth, const SYNTH_Sample_t *buffer,
+                                   uint32_t length);
+static int32_t SYNTH_Resample(void *pObj, SYNTH_Sample_t *buffer, uint32_t length);
+static inline int32_t SYNTH_ResampleTap(SYNTH_Object_t *pSynth, int32_t frame, uint32_t ch);
+static inline int64_t SYNTH_Cubic(int32_t x0, int32_t x1, int32_t x2, int32_t x3, int32_t t);
+#endif
 
 /**
   * @brief  Register the low-level hardware interface
+  * @note   A NULL Transmit is replaced by a stub that reports an error.
   * @param  pObj Pointer to Synth object
   * @param  pIO  Pointer to I/O structure
   * @retval Synth status
   */
 int32_t SYNTH_RegisterBusIO(void *pObj, SYNTH_IO_t *pIO)
 {
-  if (pIO == NULL)
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if ((pSynth == NULL) || (pIO == NULL))
   {
     return SYNTH_STATUS_ERROR;
   }
 
-  SynthIO = *pIO;
+  pSynth->IO = *pIO;
+  if (pSynth->IO.Transmit == NULL)
+  {
+    pSynth->IO.Transmit = SYNTH_DefaultTransmit;
+  }
   return SYNTH_STATUS_OK;
 }
 
+/**
+  * @brief  Register the memory backing the driver pool
+  * @note   Call before SYNTH_Init, the memory must outlive the object.
+  *         Its placement decides where pool backed state lives, e.g.
+  *         static uint8_t mem[N * SYNTH_POOL_BLOCK_SIZE] SYNTH_FAST_RAM;
+  * @param  pObj    Pointer to Synth object
+  * @param  memory  Backing memory, SYNTH_POOL_ALIGN aligned
+  * @param  size    Size of memory in bytes
+  * @retval Synth status
+  */
+int32_t SYNTH_RegisterPool(void *pObj, void *memory, uint32_t size)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if (pSynth == NULL)
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  if (pSynth->Ctx.Initialized)
+  {
+    return SYNTH_STATUS_BUSY;
+  }
+
+#if (SYNTH_MAX_SAMPLERS > 0U)
+  /* Caches taken from the previous memory are gone with it */
+  memset(pSynth->Samplers, 0, sizeof(pSynth->Samplers));
+#endif
+
+  return SYNTH_PoolInit(&pSynth->Pool, memory, size, SYNTH_POOL_BLOCK_SIZE);
+}
+
+/**
+  * @brief  Register the memory backing the effect delay lines
+  * @note   Call before SYNTH_Init, the memory must outlive the object.
+  *         Delay lines are large and only streamed a block at a time, so
+  *         this is the memory to place externally, e.g.
+  *         static uint8_t mem[N * SYNTH_BULK_BLOCK_SIZE] SYNTH_BULK_RAM;
+  * @param  pObj    Pointer to Synth object
+  * @param  memory  Backing memory, SYNTH_POOL_ALIGN aligned
+  * @param  size    Size of memory in bytes
+  * @retval Synth status
+  */
+int32_t SYNTH_RegisterBulkPool(void *pObj, void *memory, uint32_t size)
+{
+#if SYNTH_USE_FX
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if (pSynth == NULL)
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  if (pSynth->Ctx.Initialized)
+  {
+    return SYNTH_STATUS_BUSY;
+  }
+
+  /* Delay lines taken from the previous memory are gone with it */
+  memset(&pSynth->Fx, 0, sizeof(SYNTH_Fx_t));
+
+  return SYNTH_PoolInit(&pSynth->BulkPool, memory, size, SYNTH_BULK_BLOCK_SIZE);
+#else
+  (void)pObj;
+  (void)memory;
+  (void)size;
+  return SYNTH_STATUS_ERROR;
+#endif
+}
+
 /**
   * @brief  Initialize the Synth
+  * @note   Starts a clean session: callbacks, sampler slots and effects are
+  *         cleared and every block of the registered pools is free again.
   * @param  pObj         Pointer to Synth object
   * @param  sample_rate  Desired sample rate (Hz)
   * @param  channels     Number of audio channels
@@ -66,29 +384,109 @@ int32_t SYNTH_RegisterBusIO(void *pObj, SYNTH_IO_t *pIO)
   */
 int32_t SYNTH_Init(void *pObj, uint32_t sample_rate, uint8_t channels)
 {
-  (void)pObj;
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
 
-  if (SynthIO.Init == NULL)
+  /* Channel count is fixed at build time by SYNTH_CHANNELS */
+  if ((pSynth == NULL) || (pSynth->IO.Init == NULL) || (channels != SYNTH_CHANNELS))
   {
     return SYNTH_STATUS_ERROR;
   }
 
   /* Initialize low-level interface */
-  if (SynthIO.Init() != 0)
+  if (pSynth->IO.Init() != 0)
   {
     return SYNTH_STATUS_ERROR;
   }
 
   /* Default context */
-  SynthCtx.SampleRate = sample_rate;
-  SynthCtx.Channels   = channels;
-  SynthCtx.Volume     = SYNTH_DEFAULT_VOLUME;
-  SynthCtx.Mute       = 0;
-  SynthCtx.Initialized = 1;
+  pSynth->Ctx.SampleRate = sample_rate;
+  pSynth->Ctx.SourceRate = 0;
+  pSynth->Ctx.Channels   = channels;
+  pSynth->Ctx.Volume     = SYNTH_DEFAULT_VOLUME;
+  pSynth->Ctx.Mute       = 0;
+  pSynth->Ctx.Initialized = 1;
+  pSynth->Ctx.Streaming  = 0;
+  pSynth->Ctx.Transmitting = 0;
+  pSynth->Ctx.Paused     = 0;
+  pSynth->Ctx.Waveform   = SYNTH_WAVEFORM_SINE;
+
+  memset(pSynth->Voices, 0, sizeof(pSynth->Voices));
+  memcpy(pSynth->Wavetables, SynthBuiltinTables, sizeof(SynthBuiltinTables));
+#if (SYNTH_MAX_CLIPS > 0U)
+  memset(pSynth->Clips, 0, sizeof(pSynth->Clips));
+  pSynth->ClipsMixed = 0;
+#endif
+  pSynth->LastVoice   = NULL;
+  pSynth->VoiceAge    = 0;
+  pSynth->SampleClock = 0;
+  pSynth->EventHead   = 0;
+  pSynth->EventTail   = 0;
+  pSynth->Envelope.Attack  = SYNTH_DEFAULT_ATTACK_MS;
+  pSynth->Envelope.Decay   = SYNTH_DEFAULT_DECAY_MS;
+  pSynth->Envelope.Sustain = SYNTH_DEFAULT_SUSTAIN;
+  pSynth->Envelope.Release = SYNTH_DEFAULT_RELEASE_MS;
+  pSynth->PendingSampleRate = 0;
+  pSynth->PresetPending     = 0;
+  pSynth->TxCallback        = NULL;
+  pSynth->StreamCallback    = NULL;
+
+  /* Blocks held by a previous session, sampler caches and delay lines,
+     all go back to the registered memory */
+#if (SYNTH_MAX_SAMPLERS > 0U)
+  memset(pSynth->Samplers, 0, sizeof(pSynth->Samplers));
+#endif
+  if (pSynth->Pool.Base != NULL)
+  {
+    (void)SYNTH_PoolInit(&pSynth->Pool, pSynth->Pool.Base,
+                         pSynth->Pool.BlockCount * pSynth->Pool.BlockSize, SYNTH_POOL_BLOCK_SIZE);
+  }
+#if SYNTH_USE_FX
+  memset(&pSynth->Fx, 0, sizeof(SYNTH_Fx_t));
+  if (pSynth->BulkPool.Base != NULL)
+  {
+    (void)SYNTH_PoolInit(&pSynth->BulkPool, pSynth->BulkPool.Base,
+                         pSynth->BulkPool.BlockCount * pSynth->BulkPool.BlockSize,
+                         SYNTH_BULK_BLOCK_SIZE);
+  }
+#endif
+#if (SYNTH_USE_USB_INPUT == 1U)
+  pSynth->UsbActive = 0;
+#endif
+#if (SYNTH_USE_RTOS == 1U)
+  pSynth->Rtos.Task  = NULL;
+  pSynth->Rtos.Queue = NULL;
+#endif
+#if (SYNTH_USE_DUAL_CORE == 1U)
+  pSynth->SubRequest = 0;
+  pSynth->SubDone    = 0;
+  pSynth->SubDirty   = 0;
+  pSynth->SubHeld    = 0;
+  pSynth->SubMissed  = 0;
+#endif
+#if (SYNTH_USE_FILTER == 1U)
+  memset(&pSynth->VoiceFilter, 0, sizeof(SYNTH_Filter_t));
+  memset(&pSynth->MasterFilter, 0, sizeof(SYNTH_Filter_t));
+#endif
+#if (SYNTH_MAX_LFOS > 0U)
+  memset(pSynth->Lfos, 0, sizeof(pSynth->Lfos));
+  memset(pSynth->LfoPhase, 0, sizeof(pSynth->LfoPhase));
+  memset(pSynth->ModRoutes, 0, sizeof(pSynth->ModRoutes));
+  pSynth->PitchRatio = 1UL << 30;
+  pSynth->ModGain    = 32768;
+  pSynth->ModCutoff  = 0;
+#endif
+  SYNTH_ApplySampleRate(pSynth, sample_rate);
 
-  if (SynthIO.SetSampleRate)
+#if (SYNTH_USE_STATS == 1U)
+  SYNTH_CYCLE_INIT();
+  memset(&pSynth->Stats, 0, sizeof(SYNTH_Stats_t));
+#endif
+  pSynth->Gain       = SYNTH_TargetGain(pSynth);
+  pSynth->GainTarget = pSynth->Gain;
+
+  if (pSynth->IO.SetVolume)
   {
-    SynthIO.SetSampleRate(sample_rate);
+    pSynth->IO.SetVolume(pSynth->Ctx.Volume);
   }
 
   return SYNTH_STATUS_OK;
@@ -101,163 +499,3859 @@ int32_t SYNTH_Init(void *pObj, uint32_t sample_rate, uint8_t channels)
   */
 int32_t SYNTH_DeInit(void *pObj)
 {
-  (void)pObj;
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if (pSynth == NULL)
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  if (pSynth->Ctx.Streaming || pSynth->Ctx.Transmitting)
+  {
+    SYNTH_Stop(pObj);
+  }
+
+  if (pSynth->IO.DeInit)
+  {
+    pSynth->IO.DeInit();
+  }
+
+  memset(&pSynth->Ctx, 0, sizeof(SYNTH_Ctx_t));
+
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Reset the Synth runtime state
+  * @note   Stops streaming and silences every voice, the sample rate,
+  *         volume and loaded wavetables are kept.
+  * @param  pObj Pointer to Synth object
+  * @retval Synth status
+  */
+int32_t SYNTH_Reset(void *pObj)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
 
-  if (SynthIO.DeInit)
+  if ((pSynth == NULL) || (pSynth->Ctx.Initialized == 0))
   {
-    SynthIO.DeInit();
+    return SYNTH_STATUS_ERROR;
   }
 
-  memset(&SynthCtx, 0, sizeof(SYNTH_Ctx_t));
+  SYNTH_Stop(pObj);
+
+  memset(pSynth->Voices, 0, sizeof(pSynth->Voices));
+#if (SYNTH_MAX_CLIPS > 0U)
+  memset(pSynth->Clips, 0, sizeof(pSynth->Clips));
+#endif
+  pSynth->LastVoice = NULL;
+  pSynth->VoiceAge  = 0;
+  pSynth->EventTail = pSynth->EventHead;
+  pSynth->Gain       = SYNTH_TargetGain(pSynth);
+  pSynth->GainTarget = pSynth->Gain;
 
   return SYNTH_STATUS_OK;
 }
 
 /**
   * @brief  Play audio from a provided buffer
+  * @note   With a TransmitAsync hook the call returns as soon as the DMA is
+  *         started; the buffer must stay valid until the registered
+  *         SYNTH_TxCallback_t runs. Otherwise the blocking Transmit is used.
+  *         Data at another rate (SYNTH_SetSourceRate) is converted block by
+  *         block into the stream buffer and always plays asynchronously.
+  *         Volume and mute the codec cannot apply are applied in software:
+  *         through the same converter when TransmitCircular is available,
+  *         otherwise block by block through the blocking Transmit, an
+  *         error without one.
+  *         While a stream renders through SYNTH_Render, or is filled with
+  *         SYNTH_AcquireBuffer, the buffer is mixed with the voices instead,
+  *         see SYNTH_QueueBuffer. Any other stream callback leaves no room
+  *         for it and the call returns SYNTH_STATUS_BUSY.
   * @param  pObj   Pointer to Synth object
   * @param  buffer Pointer to PCM data buffer
   * @param  length Number of samples in buffer
   * @retval Synth status
   */
-int32_t SYNTH_PlayBuffer(void *pObj, const int16_t *buffer, uint32_t length)
+int32_t SYNTH_PlayBuffer(void *pObj, const SYNTH_Sample_t *buffer, uint32_t length)
 {
-  (void)pObj;
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
 
-  if (SynthCtx.Initialized == 0)
+  if ((pSynth == NULL) || (pSynth->Ctx.Initialized == 0))
   {
     return SYNTH_STATUS_ERROR;
   }
 
-  if (SynthIO.Transmit == NULL)
+#if (SYNTH_MAX_CLIPS > 0U)
+  /* Only SYNTH_Render mixes the clip bus, another callback gets BUSY */
+  if (pSynth->Ctx.Streaming && (pSynth->Ctx.Transmitting == 0U) &&
+      ((pSynth->StreamCallback == NULL) || (pSynth->StreamCallback == SYNTH_Render)))
+  {
+    return SYNTH_QueueBuffer(pObj, buffer, length, 100U, NULL);
+  }
+#endif
+
+  if ((pSynth->IO.Transmit == NULL) && (pSynth->IO.TransmitAsync == NULL))
   {
     return SYNTH_STATUS_ERROR;
   }
 
+  /* DMA owns the output while streaming or a transfer is in flight */
+  if (pSynth->Ctx.Streaming || pSynth->Ctx.Transmitting)
+  {
+    return SYNTH_STATUS_BUSY;
+  }
+
+#if (SYNTH_USE_RESAMPLER == 1U)
+  if (((pSynth->Ctx.SourceRate != 0U) && (pSynth->Ctx.SourceRate != pSynth->Ctx.SampleRate)) ||
+      ((SYNTH_TargetGain(pSynth) != 32767) && (pSynth->IO.TransmitCircular != NULL)))
+  {
+    return SYNTH_PlayResampled(pSynth, buffer, length);
+  }
+#endif
+
+  if (SYNTH_TargetGain(pSynth) != 32767)
+  {
+    return SYNTH_PlayScaled(pSynth, buffer, length);
+  }
+
   /* Convert samples to bytes for transmit */
-  uint32_t size = length * sizeof(int16_t);
-  return SynthIO.Transmit((uint8_t *)buffer, size);
+  uint32_t size = length * sizeof(SYNTH_Sample_t);
+
+  if (pSynth->IO.TransmitAsync)
+  {
+    pSynth->Ctx.Transmitting = 1;
+    if (pSynth->IO.TransmitAsync((uint8_t *)buffer, size) != 0)
+    {
+      pSynth->Ctx.Transmitting = 0;
+      return SYNTH_STATUS_ERROR;
+    }
+
+    return SYNTH_STATUS_OK;
+  }
+
+  return pSynth->IO.Transmit((uint8_t *)buffer, size);
 }
 
 /**
-  * @brief  Stop current audio playback
-  * @param  pObj Pointer to Synth object
-  * @retval Synth status
+  * @brief  Mix a PCM buffer with the voices in the render pass
+  * @note   The buffer is referenced, not copied, and must stay valid until
+  *         the registered SYNTH_TxCallback_t runs at its end. Data must be
+  *         at the output rate and starts at the next render block.
+  * @param  pObj    Pointer to Synth object
+  * @param  buffer  Interleaved PCM data in the output format
+  * @param  length  Number of samples in buffer
+  * @param  volume  Clip volume (0-100), same curve as SYNTH_SetVolume
+  * @param  slot    Pointer to return the clip slot, may be NULL
+  * @retval Synth status, SYNTH_STATUS_BUSY when every slot is playing
   */
-int32_t SYNTH_Stop(void *pObj)
+int32_t SYNTH_QueueBuffer(void *pObj, const SYNTH_Sample_t *buffer, uint32_t length,
+                          uint8_t volume, uint8_t *slot)
 {
+#if (SYNTH_MAX_CLIPS > 0U)
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+  SYNTH_Clip_t   *clip;
+  uint32_t i;
+
+  if ((pSynth == NULL) || (pSynth->Ctx.Initialized == 0) || (buffer == NULL) ||
+      (length < SYNTH_CHANNELS) ||
+      ((pSynth->Ctx.SourceRate != 0U) && (pSynth->Ctx.SourceRate != pSynth->Ctx.SampleRate)))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  for (i = 0; i < SYNTH_MAX_CLIPS; i++)
+  {
+    clip = &pSynth->Clips[i];
+    if (clip->Active == 0U)
+    {
+      clip->Data   = buffer;
+      clip->Frames = length / SYNTH_CHANNELS;
+      clip->Pos    = 0;
+      clip->Gain   = SynthVolumeTable[(volume > 100U) ? 100U : volume];
+
+      /* Fields are visible to the render pass before the slot is */
+      SYNTH_MEMORY_BARRIER();
+      clip->Active = 1;
+
+      if (slot != NULL)
+      {
+        *slot = (uint8_t)i;
+      }
+      return SYNTH_STATUS_OK;
+    }
+  }
+
+  return SYNTH_STATUS_BUSY;
+#else
   (void)pObj;
-  /* Hardware or software stop logic goes here */
-  return SYNTH_STATUS_OK;
+  (void)buffer;
+  (void)length;
+  (void)volume;
+  (void)slot;
+  return SYNTH_STATUS_ERROR;
+#endif
 }
 
 /**
-  * @brief  Set output sample rate
-  * @param  pObj         Pointer to Synth object
-  * @param  sample_rate  Desired sample rate (Hz)
+  * @brief  Change the volume of a playing clip
+  * @param  pObj    Pointer to Synth object
+  * @param  slot    Slot returned by SYNTH_QueueBuffer
+  * @param  volume  Clip volume (0-100)
   * @retval Synth status
   */
-int32_t SYNTH_SetSampleRate(void *pObj, uint32_t sample_rate)
+int32_t SYNTH_SetBufferVolume(void *pObj, uint8_t slot, uint8_t volume)
 {
+#if (SYNTH_MAX_CLIPS > 0U)
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if ((pSynth == NULL) || (slot >= SYNTH_MAX_CLIPS))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  pSynth->Clips[slot].Gain = SynthVolumeTable[(volume > 100U) ? 100U : volume];
+  return SYNTH_STATUS_OK;
+#else
   (void)pObj;
-  SynthCtx.SampleRate = sample_rate;
+  (void)slot;
+  (void)volume;
+  return SYNTH_STATUS_ERROR;
+#endif
+}
+
+/**
+  * @brief  Start mixing the USB Audio input
+  * @note   The host streams at the output rate and follows the feedback
+  *         endpoint, so no rate conversion is needed. Mixing starts once
+  *         the ring is half full and pauses to refill it after running dry.
+  *         The voices keep playing on top, leave them idle for pass-through.
+  * @param  pObj    Pointer to Synth object
+  * @param  volume  Input volume (0-100), same curve as SYNTH_SetVolume
+  * @retval Synth status
+  */
+int32_t SYNTH_StartUsbInput(void *pObj, uint8_t volume)
+{
+#if (SYNTH_USE_USB_INPUT == 1U)
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
 
-  if (SynthIO.SetSampleRate)
+  if ((pSynth == NULL) || (pSynth->Ctx.Initialized == 0))
   {
-    SynthIO.SetSampleRate(sample_rate);
+    return SYNTH_STATUS_ERROR;
   }
 
+  pSynth->UsbActive = 0;
+  SYNTH_MEMORY_BARRIER();
+
+  pSynth->UsbHead   = 0;
+  pSynth->UsbTail   = 0;
+  pSynth->UsbFill   = (SYNTH_USB_RING_FRAMES / 2U) << 8;
+  pSynth->UsbGain   = SynthVolumeTable[(volume > 100U) ? 100U : volume];
+  pSynth->UsbPrimed = 0;
+
+  SYNTH_MEMORY_BARRIER();
+  pSynth->UsbActive = 1;
   return SYNTH_STATUS_OK;
+#else
+  (void)pObj;
+  (void)volume;
+  return SYNTH_STATUS_ERROR;
+#endif
 }
 
 /**
-  * @brief  Get current sample rate
-  * @param  pObj         Pointer to Synth object
-  * @param  sample_rate  Pointer to return variable
+  * @brief  Stop mixing the USB Audio input
+  * @param  pObj  Pointer to Synth object
   * @retval Synth status
   */
-int32_t SYNTH_GetSampleRate(void *pObj, uint32_t *sample_rate)
+int32_t SYNTH_StopUsbInput(void *pObj)
 {
+#if (SYNTH_USE_USB_INPUT == 1U)
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if (pSynth == NULL)
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  pSynth->UsbActive = 0;
+  return SYNTH_STATUS_OK;
+#else
   (void)pObj;
-  if (sample_rate == NULL)
+  return SYNTH_STATUS_ERROR;
+#endif
+}
+
+/**
+  * @brief  Get the ring space for the next USB OUT packet
+  * @note   Meant for the endpoint receive setup (e.g. USBD_LL_PrepareReceive),
+  *         so the packet lands in the ring without a copy. The space holds
+  *         SYNTH_USB_PACKET_FRAMES frames and stays valid until
+  *         SYNTH_CommitUsbBuffer.
+  * @param  pObj    Pointer to Synth object
+  * @param  buffer  Pointer to return the packet address
+  * @param  length  Pointer to return the room in samples
+  * @retval Synth status, SYNTH_STATUS_BUSY when the ring is full
+  */
+int32_t SYNTH_AcquireUsbBuffer(void *pObj, SYNTH_Sample_t **buffer, uint32_t *length)
+{
+#if (SYNTH_USE_USB_INPUT == 1U)
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if ((pSynth == NULL) || (buffer == NULL) || (length == NULL) || (pSynth->UsbActive == 0U))
   {
     return SYNTH_STATUS_ERROR;
   }
 
-  *sample_rate = SynthCtx.SampleRate;
+  /* The counters run free, so a full ring and an empty one differ: a
+     packet fits while the frames it may take are not yet mixed */
+  if (((pSynth->UsbHead - pSynth->UsbTail) + SYNTH_USB_PACKET_FRAMES) > SYNTH_USB_RING_FRAMES)
+  {
+    SYNTH_STATS_INC(pSynth, UsbOverruns);
+    return SYNTH_STATUS_BUSY;
+  }
+
+  *buffer = &pSynth->UsbRing[(pSynth->UsbHead & (SYNTH_USB_RING_FRAMES - 1U)) * SYNTH_CHANNELS];
+  *length = SYNTH_USB_PACKET_FRAMES * SYNTH_CHANNELS;
   return SYNTH_STATUS_OK;
+#else
+  (void)pObj;
+  (void)buffer;
+  (void)length;
+  return SYNTH_STATUS_ERROR;
+#endif
 }
 
 /**
-  * @brief  Set the output volume
+  * @brief  Hand a received USB OUT packet to the render pass
   * @param  pObj    Pointer to Synth object
-  * @param  volume  Volume (0-100)
+  * @param  length  Number of samples received
   * @retval Synth status
   */
-int32_t SYNTH_SetVolume(void *pObj, uint8_t volume)
+int32_t SYNTH_CommitUsbBuffer(void *pObj, uint32_t length)
 {
-  (void)pObj;
-  if (volume > 100)
+#if (SYNTH_USE_USB_INPUT == 1U)
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+  uint32_t frames = length / SYNTH_CHANNELS;
+  uint32_t end;
+
+  if ((pSynth == NULL) || (pSynth->UsbActive == 0U) || (frames > SYNTH_USB_PACKET_FRAMES))
   {
-    volume = 100;
+    return SYNTH_STATUS_ERROR;
   }
 
-  SynthCtx.Volume = volume;
-  /* Optional: Apply volume in hardware here */
+  /* Frames past the ring proper belong at the bottom, which the reader
+     has already freed */
+  end = (pSynth->UsbHead & (SYNTH_USB_RING_FRAMES - 1U)) + frames;
+  if (end > SYNTH_USB_RING_FRAMES)
+  {
+    memcpy(pSynth->UsbRing, &pSynth->UsbRing[SYNTH_USB_RING_FRAMES * SYNTH_CHANNELS],
+           (end - SYNTH_USB_RING_FRAMES) * SYNTH_CHANNELS * sizeof(SYNTH_Sample_t));
+  }
 
+  /* Samples are visible before the frames are */
+  SYNTH_MEMORY_BARRIER();
+  pSynth->UsbHead += frames;
   return SYNTH_STATUS_OK;
+#else
+  (void)pObj;
+  (void)length;
+  return SYNTH_STATUS_ERROR;
+#endif
 }
 
 /**
-  * @brief  Get current volume
-  * @param  pObj    Pointer to Synth object
-  * @param  volume  Pointer to return variable
+  * @brief  Get the USB Audio feedback endpoint value
+  * @note   Nominal rate in SYNTH_USB_FEEDBACK_FORMAT, trimmed by at most
+  *         +/-0.8% in proportion to how far the averaged ring fill is from
+  *         half: a filling ring asks the host for fewer frames.
+  * @param  pObj      Pointer to Synth object
+  * @param  feedback  Pointer to return the value, transmit its low 3 bytes
+  *                   (10.14) or 4 bytes (16.16)
   * @retval Synth status
   */
-int32_t SYNTH_GetVolume(void *pObj, uint8_t *volume)
+int32_t SYNTH_GetUsbFeedback(void *pObj, uint32_t *feedback)
 {
+#if (SYNTH_USE_USB_INPUT == 1U)
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+  int64_t nominal;
+  int64_t error;
+
+  if ((pSynth == NULL) || (feedback == NULL))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+#if (SYNTH_USB_FEEDBACK_FORMAT == SYNTH_USB_FEEDBACK_16_16)
+  nominal = ((int64_t)pSynth->Ctx.SampleRate << 16) / 8000;
+#else
+  nominal = ((int64_t)pSynth->Ctx.SampleRate << 14) / 1000;
+#endif
+  error = (int64_t)pSynth->UsbFill - (int64_t)((SYNTH_USB_RING_FRAMES / 2U) << 8);
+
+  *feedback = (uint32_t)(nominal - ((nominal * error) / ((int64_t)SYNTH_USB_RING_FRAMES << 14)));
+  return SYNTH_STATUS_OK;
+#else
   (void)pObj;
+  (void)feedback;
+  return SYNTH_STATUS_ERROR;
+#endif
+}
+
+/**
+  * @brief  Stop current audio playback
+  * @param  pObj Pointer to Synth object
+  * @retval Synth status
+  */
+int32_t SYNTH_Stop(void *pObj)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
 
-  if (volume == NULL)
+  if (pSynth == NULL)
   {
     return SYNTH_STATUS_ERROR;
   }
 
-  *volume = SynthCtx.Volume;
+  if (pSynth->Ctx.Streaming || pSynth->Ctx.Transmitting)
+  {
+    if (pSynth->IO.TransmitStop)
+    {
+      pSynth->IO.TransmitStop();
+    }
+
+    pSynth->Ctx.Streaming    = 0;
+    pSynth->Ctx.Transmitting = 0;
+    pSynth->StreamCallback   = NULL;
+  }
+
+  pSynth->Ctx.Paused = 0;
+
+  /* A rate change still waiting for its fade applies right away */
+  if ((pSynth->PendingSampleRate != 0U) && SYNTH_VOICES_OWNED(pSynth))
+  {
+    SYNTH_ApplySampleRate(pSynth, pSynth->PendingSampleRate);
+    pSynth->PendingSampleRate = 0;
+  }
+
+  /* So does a preset still waiting for a block boundary */
+  if (pSynth->PresetPending)
+  {
+    SYNTH_ApplyPreset(pSynth);
+  }
+
   return SYNTH_STATUS_OK;
 }
 
 /**
-  * @brief  Enable or disable mute
-  * @param  pObj    Pointer to Synth object
-  * @param  enable  1 to mute, 0 to unmute
+  * @brief  Pause the stream or the transfer in flight
+  * @param  pObj Pointer to Synth object
   * @retval Synth status
   */
-int32_t SYNTH_Mute(void *pObj, uint8_t enable)
+int32_t SYNTH_Pause(void *pObj)
 {
-  (void)pObj;
-  SynthCtx.Mute = enable;
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if ((pSynth == NULL) || (pSynth->IO.Pause == NULL))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  if ((pSynth->Ctx.Streaming == 0) && (pSynth->Ctx.Transmitting == 0))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
 
-  if (SynthIO.Mute)
+  if (pSynth->Ctx.Paused == 0)
   {
-    SynthIO.Mute(enable);
+    if (pSynth->IO.Pause() != 0)
+    {
+      return SYNTH_STATUS_ERROR;
+    }
+
+    pSynth->Ctx.Paused = 1;
   }
 
   return SYNTH_STATUS_OK;
 }
 
 /**
-  * @brief  Dummy transmit function (used if no bus is registered)
-  * @param  pData Pointer to data
-  * @param  size  Data length
+  * @brief  Resume a paused stream or transfer
+  * @param  pObj Pointer to Synth object
   * @retval Synth status
   */
-static int32_t SYNTH_DefaultTransmit(uint8_t *pData, uint32_t size)
+int32_t SYNTH_Resume(void *pObj)
 {
-  (void)pData;
-  (void)size;
-  return SYNTH_STATUS_ERROR;
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if ((pSynth == NULL) || (pSynth->IO.Resume == NULL))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  if (pSynth->Ctx.Paused)
+  {
+    if (pSynth->IO.Resume() != 0)
+    {
+      return SYNTH_STATUS_ERROR;
+    }
+
+    pSynth->Ctx.Paused = 0;
+  }
+
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Register the asynchronous PlayBuffer completion callback
+  * @note   Register after SYNTH_Init, which clears it.
+  * @param  pObj     Pointer to Synth object
+  * @param  callback Completion callback, NULL to disable
+  * @retval Synth status
+  */
+int32_t SYNTH_RegisterTxCallback(void *pObj, SYNTH_TxCallback_t callback)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if (pSynth == NULL)
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  pSynth->TxCallback = callback;
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Set the sample rate of the data passed to SYNTH_PlayBuffer
+  * @note   Needs SYNTH_USE_RESAMPLER and a TransmitCircular hook when it
+  *         differs from the output rate.
+  * @param  pObj         Pointer to Synth object
+  * @param  sample_rate  Source rate (Hz), 0 for the output rate
+  * @retval Synth status
+  */
+int32_t SYNTH_SetSourceRate(void *pObj, uint32_t sample_rate)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if (pSynth == NULL)
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  if (pSynth->Ctx.Transmitting)
+  {
+    return SYNTH_STATUS_BUSY;
+  }
+
+#if (SYNTH_USE_RESAMPLER == 0U)
+  if ((sample_rate != 0U) && (sample_rate != pSynth->Ctx.SampleRate))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+#endif
+
+  pSynth->Ctx.SourceRate = sample_rate;
+
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Start double-buffered circular DMA streaming
+  * @note   Both halves are filled through the callback before the DMA is
+  *         started, then each half is refilled from SYNTH_TxHalfCpltCallback
+  *         and SYNTH_TxCpltCallback while the other one is playing.
+  *         With a NULL callback the stream starts silent and the application
+  *         fills released halves in place with SYNTH_AcquireBuffer and
+  *         SYNTH_CommitBuffer instead.
+  * @param  pObj     Pointer to Synth object
+  * @param  callback Refill callback (e.g. SYNTH_Render), or NULL
+  * @retval Synth status
+  */
+int32_t SYNTH_StartStream(void *pObj, SYNTH_StreamCallback_t callback)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if ((pSynth == NULL) || (pSynth->Ctx.Initialized == 0))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  if (pSynth->IO.TransmitCircular == NULL)
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  if (pSynth->Ctx.Streaming || pSynth->Ctx.Transmitting)
+  {
+    return SYNTH_STATUS_BUSY;
+  }
+
+  pSynth->StreamCallback = callback;
+  pSynth->StreamSilent   = 0;
+  pSynth->StreamFree     = 0;
+  pSynth->StreamLate     = 0;
+  pSynth->StreamMissed   = 0;
+  pSynth->StreamNext     = 0;
+  pSynth->StreamAcquired = 0;
+  SYNTH_StreamRefill(pSynth, 0);
+  SYNTH_StreamRefill(pSynth, 1);
+
+  pSynth->Ctx.Streaming = 1;
+  if (pSynth->IO.TransmitCircular((uint8_t *)pSynth->StreamBuffer,
+                                  sizeof(pSynth->StreamBuffer)) != 0)
+  {
+    pSynth->Ctx.Streaming  = 0;
+    pSynth->StreamCallback = NULL;
+    return SYNTH_STATUS_ERROR;
+  }
+
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Get the next released stream half-buffer to fill in place
+  * @note   Halves are handed out in playback order, render straight into
+  *         the returned memory then call SYNTH_CommitBuffer. A half that
+  *         is not committed before the DMA reaches it plays the
+  *         SYNTH_UNDERRUN_FILL substitute instead of stale samples.
+  * @param  pObj    Pointer to Synth object
+  * @param  buffer  Pointer to return the half-buffer address
+  * @param  length  Pointer to return the half-buffer length in samples
+  * @retval Synth status, SYNTH_STATUS_BUSY when no half is free yet,
+  *         SYNTH_STATUS_TIMEOUT when a half was missed since the last
+  *         call (the returned buffer is valid)
+  */
+int32_t SYNTH_AcquireBuffer(void *pObj, SYNTH_Sample_t **buffer, uint32_t *length)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if ((pSynth == NULL) || (buffer == NULL) || (length == NULL) || (pSynth->Ctx.Streaming == 0) ||
+      (pSynth->StreamCallback != NULL))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  if ((pSynth->StreamFree & (1U << pSynth->StreamNext)) == 0U)
+  {
+    return SYNTH_STATUS_BUSY;
+  }
+
+  *buffer = &pSynth->StreamBuffer[pSynth->StreamNext * SYNTH_STREAM_HALF_LENGTH];
+  *length = SYNTH_STREAM_HALF_LENGTH;
+  pSynth->StreamAcquired = 1;
+
+  /* The application may write anything into it */
+  SYNTH_BITS_CLEAR(pSynth->StreamSilent, 1U << pSynth->StreamNext);
+
+  if (pSynth->StreamMissed)
+  {
+    pSynth->StreamMissed = 0;
+    return SYNTH_STATUS_TIMEOUT;
+  }
+
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Hand an acquired half-buffer back to the DMA
+  * @param  pObj Pointer to Synth object
+  * @retval Synth status, SYNTH_STATUS_TIMEOUT when the half already
+  *         started playing its substitute
+  */
+int32_t SYNTH_CommitBuffer(void *pObj)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+  uint8_t late;
+
+  if ((pSynth == NULL) || (pSynth->Ctx.Streaming == 0) || (pSynth->StreamAcquired == 0U))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  SYNTH_DCACHE_CLEAN(&pSynth->StreamBuffer[pSynth->StreamNext * SYNTH_STREAM_HALF_LENGTH],
+                     SYNTH_STREAM_HALF_LENGTH * sizeof(SYNTH_Sample_t));
+
+  late = pSynth->StreamLate & (uint8_t)(1U << pSynth->StreamNext);
+
+  pSynth->StreamAcquired = 0;
+  SYNTH_BITS_CLEAR(pSynth->StreamFree, 1U << pSynth->StreamNext);
+  pSynth->StreamNext ^= 1U;
+
+  return late ? SYNTH_STATUS_TIMEOUT : SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  DMA half-transfer complete handler, first half is free
+  * @note   To be called from the BSP half-complete interrupt callback.
+  * @param  pObj Pointer to Synth object
+  * @retval None
+  */
+void SYNTH_TxHalfCpltCallback(void *pObj)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if (pSynth == NULL)
+  {
+    return;
+  }
+
+  if (pSynth->Ctx.Streaming)
+  {
+    SYNTH_StreamRefill(pSynth, 0);
+#if (SYNTH_USE_RTOS == 1U)
+    SYNTH_RenderTaskNotify(pSynth);
+#endif
+  }
+}
+
+/**
+  * @brief  DMA transfer complete handler
+  * @note   To be called from the BSP transfer-complete interrupt callback.
+  *         While streaming the second half is refilled, otherwise the
+  *         asynchronous PlayBuffer transfer is finished.
+  * @param  pObj Pointer to Synth object
+  * @retval None
+  */
+void SYNTH_TxCpltCallback(void *pObj)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if (pSynth == NULL)
+  {
+    return;
+  }
+
+  if (pSynth->Ctx.Streaming)
+  {
+    SYNTH_StreamRefill(pSynth, 1);
+#if (SYNTH_USE_RTOS == 1U)
+    SYNTH_RenderTaskNotify(pSynth);
+#endif
+  }
+  else if (pSynth->Ctx.Transmitting)
+  {
+    pSynth->Ctx.Transmitting = 0;
+
+    if (pSynth->TxCallback)
+    {
+      pSynth->TxCallback(pSynth);
+    }
+  }
+}
+
+/**
+  * @brief  Start the stream rendered by a dedicated task
+  * @note   Creates the SYNTH_USE_RTOS render task and starts pull mode
+  *         streaming. Each DMA release wakes the task, which applies up to
+  *         SYNTH_RTOS_QUEUE_LENGTH queued commands and then renders every
+  *         free half through SYNTH_Render, so the ISR stays short and the
+  *         render pass runs at a fixed priority rather than in the caller.
+  *         Other tasks then talk to the Synth through SYNTH_PostCommand only.
+  * @param  pObj  Pointer to Synth object
+  * @retval Synth status
+  */
+int32_t SYNTH_StartRenderTask(void *pObj)
+{
+#if (SYNTH_USE_RTOS == 1U)
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+  int32_t status;
+
+  if ((pSynth == NULL) || (pSynth->Ctx.Initialized == 0) || (pSynth->IO.TransmitCircular == NULL))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  if (pSynth->Rtos.Task != NULL)
+  {
+    return SYNTH_STATUS_BUSY;
+  }
+
+  if (SYNTH_RtosCreate(&pSynth->Rtos, SYNTH_RenderTask, pSynth) != SYNTH_STATUS_OK)
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  /* A failed start leaves no task behind, so the call can be retried */
+  status = SYNTH_StartStream(pObj, NULL);
+  if (status != SYNTH_STATUS_OK)
+  {
+    SYNTH_RtosDelete(&pSynth->Rtos);
+  }
+
+  return status;
+#else
+  (void)pObj;
+  return SYNTH_STATUS_ERROR;
+#endif
+}
+
+/**
+  * @brief  Queue a command for the render task
+  * @note   Safe from any number of tasks. Commands take effect at the next
+  *         half-buffer boundary; with the stream stopped the task is woken
+  *         to apply them at once.
+  * @param  pObj     Pointer to Synth object
+  * @param  command  Pointer to command, copied into the queue
+  * @param  timeout  Ticks to wait while the queue is full, 0 for none
+  * @retval Synth status, SYNTH_STATUS_BUSY when the queue stayed full
+  */
+int32_t SYNTH_PostCommand(void *pObj, const SYNTH_Command_t *command, uint32_t timeout)
+{
+#if (SYNTH_USE_RTOS == 1U)
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+  int32_t status;
+
+  if ((pSynth == NULL) || (pSynth->Ctx.Initialized == 0) || (command == NULL))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  status = SYNTH_RtosPost(&pSynth->Rtos, command, timeout);
+  if ((status == SYNTH_STATUS_OK) && (pSynth->Ctx.Streaming == 0U))
+  {
+    SYNTH_RtosNotify(&pSynth->Rtos);
+  }
+
+  return status;
+#else
+  (void)pObj;
+  (void)command;
+  (void)timeout;
+  return SYNTH_STATUS_ERROR;
+#endif
+}
+
+/**
+  * @brief  Set output sample rate
+  * @note   While streaming the change is deferred: SYNTH_Render fades the
+  *         output to zero over one block, then switches the clock and
+  *         retunes at the next block boundary and ramps back up. A custom
+  *         stream callback must render through SYNTH_Render for this,
+  *         otherwise the change lands on SYNTH_Stop.
+  * @param  pObj         Pointer to Synth object
+  * @param  sample_rate  Desired sample rate (Hz)
+  * @retval Synth status
+  */
+int32_t SYNTH_SetSampleRate(void *pObj, uint32_t sample_rate)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if ((pSynth == NULL) || (sample_rate == 0U))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  if (pSynth->Ctx.Streaming)
+  {
+    pSynth->PendingSampleRate = sample_rate;
+    SYNTH_DIRTY_RAISE(pSynth, SYNTH_DIRTY_GAIN);
+    return SYNTH_STATUS_OK;
+  }
+
+  SYNTH_ApplySampleRate(pSynth, sample_rate);
+
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Get current sample rate
+  * @param  pObj         Pointer to Synth object
+  * @param  sample_rate  Pointer to return variable
+  * @retval Synth status
+  */
+int32_t SYNTH_GetSampleRate(void *pObj, uint32_t *sample_rate)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+  if ((pSynth == NULL) || (sample_rate == NULL))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  *sample_rate = pSynth->Ctx.SampleRate;
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Set the output volume
+  * @param  pObj    Pointer to Synth object
+  * @param  volume  Volume (0-100)
+  * @retval Synth status
+  */
+int32_t SYNTH_SetVolume(void *pObj, uint8_t volume)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if (pSynth == NULL)
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  if (volume > 100)
+  {
+    volume = 100;
+  }
+
+  pSynth->Ctx.Volume = volume;
+  SYNTH_DIRTY_RAISE(pSynth, SYNTH_DIRTY_GAIN);
+
+  /* Codec gain when available, otherwise ramped in by SYNTH_Render */
+  if (pSynth->IO.SetVolume)
+  {
+    pSynth->IO.SetVolume(volume);
+  }
+
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Get current volume
+  * @param  pObj    Pointer to Synth object
+  * @param  volume  Pointer to return variable
+  * @retval Synth status
+  */
+int32_t SYNTH_GetVolume(void *pObj, uint8_t *volume)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if ((pSynth == NULL) || (volume == NULL))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  *volume = pSynth->Ctx.Volume;
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Enable or disable mute
+  * @param  pObj    Pointer to Synth object
+  * @param  enable  1 to mute, 0 to unmute
+  * @retval Synth status
+  */
+int32_t SYNTH_Mute(void *pObj, uint8_t enable)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if (pSynth == NULL)
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  pSynth->Ctx.Mute = enable;
+  SYNTH_DIRTY_RAISE(pSynth, SYNTH_DIRTY_GAIN);
+
+  if (pSynth->IO.Mute)
+  {
+    pSynth->IO.Mute(enable);
+  }
+
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Get the profiling counters
+  * @param  pObj   Pointer to Synth object
+  * @param  stats  Pointer to return structure
+  * @retval Synth status, error when built without SYNTH_USE_STATS
+  */
+int32_t SYNTH_GetStats(void *pObj, SYNTH_Stats_t *stats)
+{
+#if (SYNTH_USE_STATS == 1U)
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if ((pSynth == NULL) || (stats == NULL))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  /* Fields are updated one by one from the DMA ISR, each read is atomic */
+  *stats = pSynth->Stats;
+  stats->Underruns = pSynth->StreamUnderruns;
+  return SYNTH_STATUS_OK;
+#else
+  (void)pObj;
+  (void)stats;
+  return SYNTH_STATUS_ERROR;
+#endif
+}
+
+/**
+  * @brief  Clear the profiling counters
+  * @param  pObj  Pointer to Synth object
+  * @retval Synth status, error when built without SYNTH_USE_STATS
+  */
+int32_t SYNTH_ResetStats(void *pObj)
+{
+#if (SYNTH_USE_STATS == 1U)
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if (pSynth == NULL)
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  memset(&pSynth->Stats, 0, sizeof(SYNTH_Stats_t));
+  pSynth->StreamUnderruns = 0;
+  return SYNTH_STATUS_OK;
+#else
+  (void)pObj;
+  return SYNTH_STATUS_ERROR;
+#endif
+}
+
+/**
+  * @brief  Time the render stages in isolation
+  * @note   Starts the requested number of notes, renders blocks of
+  *         SYNTH_STREAM_BLOCK_SIZE frames into the stream buffer and
+  *         silences the voice pool again. Cycles per sample of a stage is
+  *         its cycle count divided by Frames. Not allowed while the DMA
+  *         owns the stream buffer or while a voice sounds, and the voice
+  *         allocation and output gain are restored afterwards, so no
+  *         live state is disturbed. The host harness in bench/ covers
+  *         the full render path.
+  * @param  pObj         Pointer to Synth object
+  * @param  waveform_id  Oscillator under test
+  * @param  voices       Sounding voices, at most SYNTH_MAX_VOICES
+  * @param  blocks       Number of blocks to render
+  * @param  result       Pointer to return structure
+  * @retval Synth status, error when built without SYNTH_USE_STATS
+  */
+int32_t SYNTH_Benchmark(void *pObj, uint8_t waveform_id, uint8_t voices, uint32_t blocks,
+                        SYNTH_Bench_t *result)
+{
+#if (SYNTH_USE_STATS == 1U)
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+  SYNTH_Event_t   event;
+  SYNTH_Voice_t   *last;
+  uint32_t age;
+  int32_t  gain;
+  uint32_t t0;
+  uint32_t t1;
+  uint32_t t2;
+  uint32_t b;
+  uint32_t i;
+
+  if ((pSynth == NULL) || (pSynth->Ctx.Initialized == 0) || (result == NULL) ||
+      (SYNTH_WaveformLoaded(pSynth, waveform_id) == 0U) || (voices > SYNTH_MAX_VOICES))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  if (pSynth->Ctx.Streaming || pSynth->Ctx.Transmitting || !SYNTH_VOICES_OWNED(pSynth))
+  {
+    return SYNTH_STATUS_BUSY;
+  }
+
+  /* The pool is borrowed, so it must be idle */
+  for (i = 0; i < SYNTH_MAX_VOICES; i++)
+  {
+    if (pSynth->Voices[i].Active)
+    {
+      return SYNTH_STATUS_BUSY;
+    }
+  }
+
+  last = pSynth->LastVoice;
+  age  = pSynth->VoiceAge;
+  gain = pSynth->Gain;
+
+  memset(result, 0, sizeof(SYNTH_Bench_t));
+  memset(pSynth->Voices, 0, sizeof(pSynth->Voices));
+
+  /* Spread over the keyboard so every voice runs its own increment, up to
+     MIDI 117 for a 32-voice pool */
+  event.Time      = pSynth->SampleClock;
+  event.Frequency = 0.0f;
+  event.Type      = SYNTH_EVENT_NOTE_ON;
+  event.Velocity  = 100;
+  event.Waveform  = waveform_id;
+  for (i = 0; i < voices; i++)
+  {
+    event.Note = (uint8_t)(24U + (i * 3U));
+    SYNTH_ApplyEvent(pSynth, &event, SYNTH_STREAM_BLOCK_SIZE);
+  }
+
+  for (b = 0; b < blocks; b++)
+  {
+    t0 = SYNTH_CYCLE_COUNT();
+    for (i = 0; i < SYNTH_MAX_VOICES; i++)
+    {
+      if (pSynth->Voices[i].Active)
+      {
+        SYNTH_EnvelopeBlock(pSynth, &pSynth->Voices[i], SYNTH_STREAM_BLOCK_SIZE);
+      }
+    }
+
+    t1 = SYNTH_CYCLE_COUNT();
+    memset(pSynth->MixBuffer, 0, sizeof(pSynth->MixBuffer));
+    SYNTH_RenderVoices(pSynth, pSynth->MixBuffer, SYNTH_VOICE_SCRATCH(pSynth),
+                       SYNTH_STREAM_BLOCK_SIZE, 0, 1);
+
+    t2 = SYNTH_CYCLE_COUNT();
+    SYNTH_OutputBlock(pSynth, pSynth->StreamBuffer, SYNTH_STREAM_BLOCK_SIZE);
+
+    result->EnvelopeCycles   += t1 - t0;
+    result->OscillatorCycles += t2 - t1;
+    result->OutputCycles     += SYNTH_CYCLE_COUNT() - t2;
+  }
+
+  result->Frames = blocks * SYNTH_STREAM_BLOCK_SIZE;
+
+  memset(pSynth->Voices, 0, sizeof(pSynth->Voices));
+  pSynth->LastVoice    = last;
+  pSynth->VoiceAge     = age;
+  pSynth->Gain         = gain;
+  pSynth->StreamSilent = 0;
+
+  return SYNTH_STATUS_OK;
+#else
+  (void)pObj;
+  (void)waveform_id;
+  (void)voices;
+  (void)blocks;
+  (void)result;
+  return SYNTH_STATUS_ERROR;
+#endif
+}
+
+/**
+  * @brief  Select the waveform used by subsequent notes
+  * @param  pObj         Pointer to Synth object
+  * @param  waveform_id  SYNTH_WAVEFORM_xxx identifier
+  * @retval Synth status
+  */
+int32_t SYNTH_SetWaveform(void *pObj, uint8_t waveform_id)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if ((pSynth == NULL) || (SYNTH_WaveformLoaded(pSynth, waveform_id) == 0U))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  pSynth->Ctx.Waveform = waveform_id;
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Set the ADSR envelope used by every voice
+  * @note   Coefficients are derived once here, voices pick them up at their
+  *         next block boundary.
+  * @param  pObj      Pointer to Synth object
+  * @param  envelope  Pointer to envelope settings
+  * @retval Synth status
+  */
+int32_t SYNTH_SetEnvelope(void *pObj, const SYNTH_Envelope_t *envelope)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if ((pSynth == NULL) || (envelope == NULL) || (envelope->Sustain > 100U))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  pSynth->Envelope = *envelope;
+  SYNTH_UpdateEnvelope(pSynth);
+
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Configure the voice or master low-pass filter
+  * @note   Coefficients are looked up from the per-note table at the next
+  *         block boundary, so sweeping the cutoff costs no trigonometry.
+  * @param  pObj    Pointer to Synth object
+  * @param  stage   SYNTH_FILTER_VOICE or SYNTH_FILTER_MASTER
+  * @param  filter  Pointer to filter settings
+  * @retval Synth status, error when built without SYNTH_USE_FILTER
+  */
+int32_t SYNTH_SetFilter(void *pObj, uint8_t stage, const SYNTH_Filter_t *filter)
+{
+#if (SYNTH_USE_FILTER == 1U)
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+  float   q;
+  int32_t damp;
+
+  if ((pSynth == NULL) || (filter == NULL) || (filter->Resonance > 100U) ||
+      (stage > SYNTH_FILTER_MASTER))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  q    = 0.70710678f + ((float)filter->Resonance * 0.09292893f);
+  damp = (int32_t)(32768.0f / q);
+
+  if (stage == SYNTH_FILTER_MASTER)
+  {
+    if (pSynth->MasterFilter.Enable == 0U)
+    {
+      memset(pSynth->MasterState, 0, sizeof(pSynth->MasterState));
+    }
+    pSynth->MasterFilterDamp = damp;
+    pSynth->MasterFilter     = *filter;
+    SYNTH_DIRTY_RAISE(pSynth, SYNTH_DIRTY_MASTER_FILTER);
+  }
+  else
+  {
+    pSynth->VoiceFilterDamp = damp;
+    pSynth->VoiceFilter     = *filter;
+    SYNTH_DIRTY_RAISE(pSynth, SYNTH_DIRTY_VOICE_FILTER);
+  }
+
+  return SYNTH_STATUS_OK;
+#else
+  (void)pObj;
+  (void)stage;
+  (void)filter;
+  return SYNTH_STATUS_ERROR;
+#endif
+}
+
+/**
+  * @brief  Configure the master echo
+  * @note   The effect is off while its delay line is resized and cleared,
+  *         then switches on at a block boundary.
+  * @param  pObj   Pointer to Synth object
+  * @param  delay  Pointer to echo settings
+  * @retval Synth status, error when the bulk pool cannot hold the line
+  */
+int32_t SYNTH_SetDelay(void *pObj, const SYNTH_Delay_t *delay)
+{
+#if (SYNTH_USE_DELAY == 1U)
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if (pSynth == NULL)
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  pSynth->Fx.Delay.Enable = 0;
+  SYNTH_MEMORY_BARRIER();
+
+  if (SYNTH_FxSetDelay(&pSynth->Fx, &pSynth->BulkPool, delay, pSynth->Ctx.SampleRate) !=
+      SYNTH_STATUS_OK)
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  SYNTH_MEMORY_BARRIER();
+  pSynth->Fx.Delay.Enable = delay->Enable;
+  return SYNTH_STATUS_OK;
+#else
+  (void)pObj;
+  (void)delay;
+  return SYNTH_STATUS_ERROR;
+#endif
+}
+
+/**
+  * @brief  Configure the master chorus
+  * @param  pObj    Pointer to Synth object
+  * @param  chorus  Pointer to chorus settings
+  * @retval Synth status
+  */
+int32_t SYNTH_SetChorus(void *pObj, const SYNTH_Chorus_t *chorus)
+{
+#if (SYNTH_USE_CHORUS == 1U)
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if (pSynth == NULL)
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  pSynth->Fx.Chorus.Enable = 0;
+  SYNTH_MEMORY_BARRIER();
+
+  if (SYNTH_FxSetChorus(&pSynth->Fx, &pSynth->BulkPool, chorus, pSynth->Ctx.SampleRate) !=
+      SYNTH_STATUS_OK)
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  SYNTH_MEMORY_BARRIER();
+  pSynth->Fx.Chorus.Enable = chorus->Enable;
+  return SYNTH_STATUS_OK;
+#else
+  (void)pObj;
+  (void)chorus;
+  return SYNTH_STATUS_ERROR;
+#endif
+}
+
+/**
+  * @brief  Configure the master reverb
+  * @param  pObj    Pointer to Synth object
+  * @param  reverb  Pointer to reverb settings
+  * @retval Synth status
+  */
+int32_t SYNTH_SetReverb(void *pObj, const SYNTH_Reverb_t *reverb)
+{
+#if (SYNTH_USE_REVERB == 1U)
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if (pSynth == NULL)
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  pSynth->Fx.Reverb.Enable = 0;
+  SYNTH_MEMORY_BARRIER();
+
+  if (SYNTH_FxSetReverb(&pSynth->Fx, &pSynth->BulkPool, reverb, pSynth->Ctx.SampleRate) !=
+      SYNTH_STATUS_OK)
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  SYNTH_MEMORY_BARRIER();
+  pSynth->Fx.Reverb.Enable = reverb->Enable;
+  return SYNTH_STATUS_OK;
+#else
+  (void)pObj;
+  (void)reverb;
+  return SYNTH_STATUS_ERROR;
+#endif
+}
+
+/**
+  * @brief  Configure a low-frequency oscillator
+  * @note   LFOs advance once per render block, route them with
+  *         SYNTH_SetModRoute.
+  * @param  pObj      Pointer to Synth object
+  * @param  lfo       LFO index, below SYNTH_MAX_LFOS
+  * @param  settings  Pointer to LFO settings
+  * @retval Synth status
+  */
+int32_t SYNTH_SetLfo(void *pObj, uint8_t lfo, const SYNTH_Lfo_t *settings)
+{
+#if (SYNTH_MAX_LFOS > 0U)
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if ((pSynth == NULL) || (lfo >= SYNTH_MAX_LFOS) || (settings == NULL) ||
+      (settings->Shape >= SYNTH_WAVEFORM_SAMPLER) || (pSynth->Wavetables[settings->Shape] == NULL))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  pSynth->Lfos[lfo] = *settings;
+  SYNTH_UpdateLfoIncs(pSynth);
+  return SYNTH_STATUS_OK;
+#else
+  (void)pObj;
+  (void)lfo;
+  (void)settings;
+  return SYNTH_STATUS_ERROR;
+#endif
+}
+
+/**
+  * @brief  Set one modulation matrix entry
+  * @note   Entries on the same target add up, amplitude entries multiply.
+  *         SYNTH_MOD_NONE clears the entry.
+  * @param  pObj   Pointer to Synth object
+  * @param  slot   Matrix entry, below SYNTH_MOD_SLOTS
+  * @param  route  Pointer to routing
+  * @retval Synth status
+  */
+int32_t SYNTH_SetModRoute(void *pObj, uint8_t slot, const SYNTH_ModRoute_t *route)
+{
+#if (SYNTH_MAX_LFOS > 0U)
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if ((pSynth == NULL) || (slot >= SYNTH_MOD_SLOTS) || (route == NULL) ||
+      (route->Source >= SYNTH_MAX_LFOS) || (route->Target > SYNTH_MOD_CUTOFF) ||
+      ((route->Target == SYNTH_MOD_AMP) && ((route->Depth > 100) || (route->Depth < -100))) ||
+      ((route->Target == SYNTH_MOD_PITCH) &&
+       ((route->Depth > SYNTH_MOD_PITCH_RANGE) || (route->Depth < -SYNTH_MOD_PITCH_RANGE))))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  pSynth->ModRoutes[slot] = *route;
+  return SYNTH_STATUS_OK;
+#else
+  (void)pObj;
+  (void)slot;
+  (void)route;
+  return SYNTH_STATUS_ERROR;
+#endif
+}
+
+/**
+  * @brief  Register a user wavetable
+  * @note   The table is referenced, not copied, so it may live in flash.
+  *         Voices already playing keep their table until retriggered.
+  * @param  pObj         Pointer to Synth object
+  * @param  waveform_id  Slot, SYNTH_WAVEFORM_USER or above
+  * @param  table        One period of SYNTH_WAVETABLE_SIZE Q15 samples
+  * @retval Synth status
+  */
+int32_t SYNTH_LoadWavetable(void *pObj, uint8_t waveform_id, const int16_t *table)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if ((pSynth == NULL) || (waveform_id < SYNTH_WAVEFORM_USER) ||
+      (waveform_id >= SYNTH_WAVEFORM_SAMPLER) || (table == NULL))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  pSynth->Wavetables[waveform_id] = table;
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Register a sampler slot playing PCM in place
+  * @note   Samples are read straight from the descriptor's Data, typically
+  *         internal flash or memory-mapped QSPI/OCTOSPI. With
+  *         SYNTH_SAMPLER_CACHE the loop, or the start of the sample when
+  *         the loop does not fit, is also copied into one pool block so the
+  *         region replayed for every sustained note comes from SRAM. Load a
+  *         slot while none of its voices is sounding.
+  * @param  pObj         Pointer to Synth object
+  * @param  waveform_id  Slot, SYNTH_WAVEFORM_SAMPLER or above
+  * @param  sampler      Pointer to sampler descriptor
+  * @retval Synth status
+  */
+int32_t SYNTH_LoadSampler(void *pObj, uint8_t waveform_id, const SYNTH_Sampler_t *sampler)
+{
+#if (SYNTH_MAX_SAMPLERS > 0U)
+  SYNTH_Object_t      *pSynth = (SYNTH_Object_t *)pObj;
+  SYNTH_SamplerSlot_t *slot;
+  float    root;
+  float    scale;
+#if (SYNTH_SAMPLER_CACHE == 1U)
+  uint32_t cap = SYNTH_POOL_BLOCK_SIZE / sizeof(int16_t);
+  uint32_t start = 0;
+  uint32_t frames;
+#endif
+
+  if ((pSynth == NULL) || (waveform_id < SYNTH_WAVEFORM_SAMPLER) ||
+      (waveform_id >= SYNTH_WAVEFORM_COUNT) || (sampler == NULL) || (sampler->Data == NULL) ||
+      (sampler->Length == 0U) ||
+      (sampler->LoopEnd > sampler->Length) || (sampler->LoopStart > sampler->LoopEnd) ||
+      (sampler->SampleRate == 0U) || (sampler->RootNote > 127U))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  slot = &pSynth->Samplers[waveform_id - SYNTH_WAVEFORM_SAMPLER];
+
+  /* Frames per period at the root pitch turn a table increment into a
+     sample step with one multiply, see SYNTH_TuneVoice */
+  root  = SynthOctaveFreq[sampler->RootNote % 12U] *
+          (float)(1UL << (sampler->RootNote / 12U)) / 32.0f;
+  scale = ((float)sampler->SampleRate * 65536.0f) / root;
+  slot->Scale       = (scale >= 4294967040.0f) ? 0xFFFFFFFFUL : (uint32_t)scale;
+  slot->CacheFrames = 0;
+  slot->Desc        = sampler;
+
+#if (SYNTH_SAMPLER_CACHE == 1U)
+  if (slot->Cache == NULL)
+  {
+    slot->Cache = (const int16_t *)SYNTH_PoolAlloc(&pSynth->Pool);
+  }
+
+  if (slot->Cache != NULL)
+  {
+    frames = sampler->LoopEnd - sampler->LoopStart;
+    if ((frames != 0U) && (frames <= cap))
+    {
+      start = sampler->LoopStart;
+    }
+    else
+    {
+      frames = (sampler->Length < cap) ? sampler->Length : cap;
+    }
+
+    memcpy((void *)(uintptr_t)slot->Cache, &sampler->Data[start], frames * sizeof(int16_t));
+    slot->CacheStart  = start;
+    slot->CacheFrames = frames;
+  }
+#endif
+
+  return SYNTH_STATUS_OK;
+#else
+  (void)pObj;
+  (void)waveform_id;
+  (void)sampler;
+  return SYNTH_STATUS_ERROR;
+#endif
+}
+
+/**
+  * @brief  Load a preset image
+  * @note   The image is copied and checked once here, no parsing. Notes
+  *         posted from now on use its waveform, the envelope and filters
+  *         switch together at the next block boundary of SYNTH_Render, or
+  *         right away when no stream is running.
+  * @param  pObj  Pointer to Synth object
+  * @param  data  Preset image, e.g. a file read as is, any alignment
+  * @param  size  Bytes in data, at least sizeof(SYNTH_Preset_t)
+  * @retval Synth status
+  */
+int32_t SYNTH_LoadPreset(void *pObj, const void *data, uint32_t size)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+  SYNTH_Preset_t image;
+  SYNTH_Preset_t *preset;
+
+  if ((pSynth == NULL) || (pSynth->Ctx.Initialized == 0) || (data == NULL) ||
+      (size < sizeof(SYNTH_Preset_t)))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  /* Checked in a copy, data need not be aligned and a rejected image
+     leaves the stored and any pending preset alone */
+  memcpy(&image, data, sizeof(SYNTH_Preset_t));
+
+  if ((image.Magic != SYNTH_PRESET_MAGIC) || (image.Version != SYNTH_PRESET_VERSION) ||
+      (image.Size != sizeof(SYNTH_Preset_t)) || (image.Envelope.Sustain > 100U) ||
+      (image.VoiceFilter.Resonance > 100U) || (image.MasterFilter.Resonance > 100U) ||
+      (SYNTH_WaveformLoaded(pSynth, image.Waveform) == 0U))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  preset = &pSynth->Preset;
+
+  /* The render stage must not pick up a half-written image */
+  pSynth->PresetPending = 0;
+  SYNTH_MEMORY_BARRIER();
+  memcpy(preset, &image, sizeof(SYNTH_Preset_t));
+
+  pSynth->Ctx.Waveform = preset->Waveform;
+
+  if (pSynth->Ctx.Streaming == 0U)
+  {
+    SYNTH_ApplyPreset(pSynth);
+    return SYNTH_STATUS_OK;
+  }
+
+  SYNTH_MEMORY_BARRIER();
+  pSynth->PresetPending = 1;
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Capture the current sound settings as a preset image
+  * @param  pObj    Pointer to Synth object
+  * @param  preset  Pointer to the image to fill
+  * @retval Synth status
+  */
+int32_t SYNTH_SavePreset(void *pObj, SYNTH_Preset_t *preset)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+
+  if ((pSynth == NULL) || (preset == NULL))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  memset(preset, 0, sizeof(SYNTH_Preset_t));
+  preset->Magic    = SYNTH_PRESET_MAGIC;
+  preset->Version  = SYNTH_PRESET_VERSION;
+  preset->Size     = sizeof(SYNTH_Preset_t);
+  preset->Envelope = pSynth->Envelope;
+  preset->Waveform = pSynth->Ctx.Waveform;
+#if (SYNTH_USE_FILTER == 1U)
+  preset->VoiceFilter  = pSynth->VoiceFilter;
+  preset->MasterFilter = pSynth->MasterFilter;
+#endif
+
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Retune the most recently triggered voice
+  * @param  pObj       Pointer to Synth object
+  * @param  frequency  Frequency in Hz
+  * @retval Synth status
+  */
+int32_t SYNTH_SetFrequency(void *pObj, float frequency)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+  SYNTH_Event_t event;
+
+  if ((pSynth == NULL) || (pSynth->Ctx.Initialized == 0) || !(frequency > 0.0f))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  event.Time      = pSynth->SampleClock;
+  event.Frequency = frequency;
+  event.Type      = SYNTH_EVENT_FREQUENCY;
+  event.Note      = 0;
+  event.Velocity  = 0;
+  event.Waveform  = 0;
+
+  return SYNTH_PostEvent(pObj, &event);
+}
+
+/**
+  * @brief  Start a note on a free or stolen voice
+  * @note   Queued, the note starts at the next render block.
+  * @param  pObj      Pointer to Synth object
+  * @param  note      MIDI note number (0-127)
+  * @param  velocity  MIDI velocity (1-127), 0 is handled as note off
+  * @retval Synth status
+  */
+int32_t SYNTH_NoteOn(void *pObj, uint8_t note, uint8_t velocity)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+  SYNTH_Event_t event;
+
+  if ((pSynth == NULL) || (pSynth->Ctx.Initialized == 0) || (note > 127U) || (velocity > 127U))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  event.Time      = pSynth->SampleClock;
+  event.Frequency = 0.0f;
+  event.Type      = (velocity == 0U) ? SYNTH_EVENT_NOTE_OFF : SYNTH_EVENT_NOTE_ON;
+  event.Note      = note;
+  event.Velocity  = velocity;
+  event.Waveform  = pSynth->Ctx.Waveform;
+
+  return SYNTH_PostEvent(pObj, &event);
+}
+
+/**
+  * @brief  Stop every voice playing a note
+  * @note   Queued, the note stops at the next render block.
+  * @param  pObj  Pointer to Synth object
+  * @param  note  MIDI note number (0-127)
+  * @retval Synth status
+  */
+int32_t SYNTH_NoteOff(void *pObj, uint8_t note)
+{
+  return SYNTH_NoteOn(pObj, note, 0);
+}
+
+/**
+  * @brief  Queue a timestamped event for the render stage
+  * @note   Single producer, single consumer: one context (e.g. the MIDI
+  *         UART interrupt) posts while SYNTH_Render drains, without any
+  *         critical section. Events are applied in order, each at the
+  *         first sample where SampleClock reaches its Time.
+  * @param  pObj   Pointer to Synth object
+  * @param  event  Pointer to event, copied into the queue
+  * @retval Synth status, SYNTH_STATUS_BUSY when the queue is full
+  */
+int32_t SYNTH_PostEvent(void *pObj, const SYNTH_Event_t *event)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+  uint32_t head;
+
+  if ((pSynth == NULL) || (pSynth->Ctx.Initialized == 0) || (event == NULL))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  head = pSynth->EventHead;
+  if ((head - pSynth->EventTail) >= SYNTH_EVENT_QUEUE_SIZE)
+  {
+    return SYNTH_STATUS_BUSY;
+  }
+
+  pSynth->Events[head & (SYNTH_EVENT_QUEUE_SIZE - 1U)] = *event;
+
+  /* Slot contents must be visible before the consumer sees the new head */
+  SYNTH_MEMORY_BARRIER();
+  pSynth->EventHead = head + 1U;
+
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Render the voice pool into an interleaved PCM buffer
+  * @note   Queued events are applied and voices are summed block by block
+  *         into a mono accumulator, then SYNTH_OutputBlock applies the
+  *         software volume, saturates and interleaves in a single pass.
+  * @param  pObj    Pointer to Synth object
+  * @param  buffer  Pointer to PCM output buffer
+  * @param  length  Number of samples in buffer
+  * @retval Synth status, SYNTH_STATUS_TIMEOUT when a dual-core block went
+  *         out without the second core's voices
+  */
+int32_t SYNTH_Render(void *pObj, SYNTH_Sample_t *buffer, uint32_t length)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+  uint32_t frames;
+  uint32_t count;
+  uint32_t half;
+#if (SYNTH_USE_STATS == 1U)
+  uint32_t start;
+  uint32_t mixed;
+#endif
+
+  if ((pSynth == NULL) || (pSynth->Ctx.Initialized == 0) || (buffer == NULL))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  frames = length / SYNTH_CHANNELS;
+  half   = SYNTH_StreamHalfMask(pSynth, buffer);
+
+  /* A deferred rate change lands once the previous block faded to zero */
+  if ((pSynth->PendingSampleRate != 0U) && (pSynth->Gain == 0) && SYNTH_VOICES_OWNED(pSynth))
+  {
+    SYNTH_ApplySampleRate(pSynth, pSynth->PendingSampleRate);
+    pSynth->PendingSampleRate = 0;
+  }
+
+  /* A loaded preset switches between buffers, never inside one */
+  if (pSynth->PresetPending)
+  {
+    SYNTH_ApplyPreset(pSynth);
+  }
+
+  /* Nothing can sound before the end of this buffer: skip voices, mixer
+     and output, and leave a stream half alone if it already holds zeros */
+  if (SYNTH_IsSilent(pSynth, frames))
+  {
+    if ((pSynth->StreamSilent & half) == 0U)
+    {
+      memset(buffer, 0, frames * SYNTH_CHANNELS * sizeof(SYNTH_Sample_t));
+      SYNTH_BITS_SET(pSynth->StreamSilent, half);
+    }
+
+    (void)SYNTH_RefreshBlock(pSynth);
+    pSynth->Gain = pSynth->GainTarget;
+    pSynth->SampleClock += frames;
+    return SYNTH_STATUS_OK;
+  }
+
+  SYNTH_BITS_CLEAR(pSynth->StreamSilent, half);
+
+  while (frames > 0U)
+  {
+    count = (frames > SYNTH_STREAM_BLOCK_SIZE) ? SYNTH_STREAM_BLOCK_SIZE : frames;
+#if (SYNTH_USE_STATS == 1U)
+    start = SYNTH_CYCLE_COUNT();
+    SYNTH_RenderBlock(pSynth, count);
+    mixed = SYNTH_CYCLE_COUNT();
+    SYNTH_OutputBlock(pSynth, buffer, count);
+    SYNTH_StatsRecord(&pSynth->Stats.MixCycles, &pSynth->Stats.MixCyclesMax, mixed - start);
+    SYNTH_StatsRecord(&pSynth->Stats.RenderCycles, &pSynth->Stats.RenderCyclesMax,
+                      SYNTH_CYCLE_COUNT() - start);
+#else
+    SYNTH_RenderBlock(pSynth, count);
+
+    SYNTH_OutputBlock(pSynth, buffer, count);
+#endif
+
+    buffer += count * SYNTH_CHANNELS;
+    pSynth->SampleClock += count;
+    frames -= count;
+  }
+
+#if (SYNTH_USE_DUAL_CORE == 1U)
+  if (pSynth->SubMissed)
+  {
+    pSynth->SubMissed = 0;
+    return SYNTH_STATUS_TIMEOUT;
+  }
+#endif
+
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Render the odd voice slots of the requested block
+  * @note   Runs on the second core, from the SYNTH_HSEM_RENDER interrupt.
+  *         Returns at once when no block is waiting. The odd voices,
+  *         envelopes included, are only written here until SubDone is set.
+  * @param  pObj  Pointer to Synth object
+  * @retval Synth status
+  */
+int32_t SYNTH_RenderSecondary(void *pObj)
+{
+#if (SYNTH_USE_DUAL_CORE == 1U)
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+  uint32_t seq;
+
+  if (pSynth == NULL)
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  seq = pSynth->SubRequest;
+
+  if (seq == pSynth->SubDone)
+  {
+    return SYNTH_STATUS_OK;
+  }
+
+  SYNTH_MEMORY_BARRIER();
+  SYNTH_PrepareVoices(pSynth, pSynth->SubFrames, pSynth->SubDirty, 1, 2);
+  memset(pSynth->SubMix, 0, pSynth->SubFrames * sizeof(int32_t));
+#if (SYNTH_USE_FILTER == 1U)
+  SYNTH_RenderVoices(pSynth, pSynth->SubMix, pSynth->SubVoiceBuffer, pSynth->SubFrames, 1, 2);
+#else
+  SYNTH_RenderVoices(pSynth, pSynth->SubMix, NULL, pSynth->SubFrames, 1, 2);
+#endif
+
+  /* Sub-mix and voices are complete before the first core reads them */
+  SYNTH_MEMORY_BARRIER();
+  pSynth->SubDone = seq;
+
+  return SYNTH_STATUS_OK;
+#else
+  (void)pObj;
+
+  return SYNTH_STATUS_ERROR;
+#endif
+}
+
+/**
+  * @brief  Get the number of sounding voices
+  * @note   Zero means SYNTH_Render costs only the idle check, the
+  *         application may also use it to decide when to Pause the stream.
+  * @param  pObj   Pointer to Synth object
+  * @param  count  Pointer to return variable
+  * @retval Synth status
+  */
+int32_t SYNTH_GetActiveVoices(void *pObj, uint8_t *count)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+  uint32_t i;
+
+  if ((pSynth == NULL) || (count == NULL))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  *count = 0;
+  for (i = 0; i < SYNTH_MAX_VOICES; i++)
+  {
+    if (pSynth->Voices[i].Active)
+    {
+      (*count)++;
+    }
+  }
+
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Saturate to the SYNTH_SAMPLE_BITS range
+  * @param  x  Sample at output scale, at most 31 bits for 16/24-bit output
+  * @retval Saturated sample
+  */
+static inline int32_t SYNTH_SatSample(int64_t x)
+{
+#if (SYNTH_SAMPLE_BITS == 16U)
+  return SYNTH_SSAT16((int32_t)x);
+#elif (SYNTH_SAMPLE_BITS == 24U)
+  return SYNTH_SSAT24((int32_t)x);
+#else
+  return SYNTH_SSAT32(x);
+#endif
+}
+
+/**
+  * @brief  Scale one accumulator sample by a Q15 gain and saturate
+  * @param  x     Mix accumulator sample
+  * @param  gain  Q30 ramped gain, only the top Q15 part is used
+  * @retval Sample in the SYNTH_SAMPLE_BITS range
+  */
+static inline int32_t SYNTH_ScaleSample(int32_t x, int32_t gain)
+{
+  return SYNTH_SatSample(((int64_t)x * (gain >> 15)) >> SYNTH_OUTPUT_SHIFT);
+}
+
+/**
+  * @brief  Convert the mix accumulator to interleaved output samples
+  * @note   The Q15 gain is ramped linearly from the current to the target
+  *         value across the block to avoid zipper noise. 16-bit stereo
+  *         frames are packed and written as one word, 16-bit mono frames
+  *         two at a time. Wide samples are stored one word each. Stereo
+  *         clips are added per channel on the way out.
+  * @param  pSynth  Pointer to Synth object
+  * @param  buffer  Pointer to PCM output buffer
+  * @param  frames  Number of frames, at most SYNTH_STREAM_BLOCK_SIZE
+  * @retval None
+  */
+static void SYNTH_OutputBlock(SYNTH_Object_t *pSynth, SYNTH_Sample_t *buffer, uint32_t frames)
+{
+  const int32_t *mix = pSynth->MixBuffer;
+  int32_t  target = pSynth->GainTarget;
+  int32_t  gain   = pSynth->Gain << 15;
+  int32_t  step   = ((target - pSynth->Gain) << 15) / (int32_t)frames;
+  int32_t  s0;
+  int32_t  s1;
+  uint32_t i;
+#if (SYNTH_MAX_CLIPS > 0U) && (SYNTH_CHANNELS == 2U)
+  const int32_t *clip = pSynth->ClipsMixed ? pSynth->ClipBuffer : NULL;
+#endif
+
+#if (SYNTH_CHANNELS == 2U)
+  for (i = 0; i < frames; i++)
+  {
+#if (SYNTH_MAX_CLIPS > 0U)
+    if (clip != NULL)
+    {
+      s0 = SYNTH_ScaleSample(mix[i] + clip[2U * i], gain);
+      s1 = SYNTH_ScaleSample(mix[i] + clip[(2U * i) + 1U], gain);
+    }
+    else
+#endif
+    {
+      s0 = SYNTH_ScaleSample(mix[i], gain);
+      s1 = s0;
+    }
+    gain += step;
+
+#if (SYNTH_SAMPLE_BITS != 16U)
+    *buffer++ = s0;
+    *buffer++ = s1;
+#else
+    SYNTH_WRITE32(buffer, SYNTH_PACK16(s0, s1));
+    buffer += 2;
+#endif
+  }
+#elif (SYNTH_SAMPLE_BITS != 16U)
+  (void)s1;
+
+  for (i = 0; i < frames; i++)
+  {
+    s0    = SYNTH_ScaleSample(mix[i], gain);
+    gain += step;
+    *buffer++ = s0;
+  }
+#else
+  for (i = 0; (i + 1U) < frames; i += 2U)
+  {
+    s0    = SYNTH_ScaleSample(mix[i], gain);
+    gain += step;
+    s1    = SYNTH_ScaleSample(mix[i + 1U], gain);
+    gain += step;
+    SYNTH_WRITE32(buffer, SYNTH_PACK16(s0, s1));
+    buffer += 2;
+  }
+
+  if (i < frames)
+  {
+    *buffer = (int16_t)SYNTH_ScaleSample(mix[i], gain);
+  }
+#endif
+
+  pSynth->Gain = target;
+}
+
+/**
+  * @brief  Check whether the next frames are guaranteed silent
+  * @param  pSynth  Pointer to Synth object
+  * @param  frames  Number of frames about to be rendered
+  * @retval 1 if no voice, clip or effect is active and no event is due within frames
+  */
+static uint8_t SYNTH_IsSilent(SYNTH_Object_t *pSynth, uint32_t frames)
+{
+  uint32_t tail = pSynth->EventTail;
+  uint32_t i;
+
+  for (i = 0; i < SYNTH_MAX_VOICES; i++)
+  {
+    if (pSynth->Voices[i].Active)
+    {
+      return 0;
+    }
+  }
+
+#if (SYNTH_MAX_CLIPS > 0U)
+  for (i = 0; i < SYNTH_MAX_CLIPS; i++)
+  {
+    if (pSynth->Clips[i].Active)
+    {
+      return 0;
+    }
+  }
+#endif
+
+#if (SYNTH_USE_USB_INPUT == 1U)
+  if (pSynth->UsbActive)
+  {
+    return 0;
+  }
+#endif
+
+#if SYNTH_USE_FX
+  /* Effect tails outlive the voices */
+  if (SYNTH_FxActive(&pSynth->Fx))
+  {
+    return 0;
+  }
+#endif
+
+  if ((tail != pSynth->EventHead) &&
+      ((int32_t)(pSynth->Events[tail & (SYNTH_EVENT_QUEUE_SIZE - 1U)].Time -
+                 (pSynth->SampleClock + frames)) < 0))
+  {
+    return 0;
+  }
+
+  return 1;
+}
+
+/**
+  * @brief  Map a buffer to its stream half bit
+  * @param  pSynth  Pointer to Synth object
+  * @param  buffer  Pointer to PCM buffer
+  * @retval 1 or 2 for the first or second stream half, 0 otherwise
+  */
+static uint32_t SYNTH_StreamHalfMask(SYNTH_Object_t *pSynth, const SYNTH_Sample_t *buffer)
+{
+  if (buffer == &pSynth->StreamBuffer[0])
+  {
+    return 1U;
+  }
+
+  if (buffer == &pSynth->StreamBuffer[SYNTH_STREAM_HALF_LENGTH])
+  {
+    return 2U;
+  }
+
+  return 0U;
+}
+
+/**
+  * @brief  Render one block of the voice pool into the mix accumulator
+  * @note   Envelopes advance once per block, then the block is split at
+  *         each queued event timestamp so note starts and stops land on the
+  *         exact sample. With the dual-core split each core advances its
+  *         own voices, see SYNTH_RenderDual.
+  * @param  pSynth  Pointer to Synth object
+  * @param  frames  Number of frames, at most SYNTH_STREAM_BLOCK_SIZE
+  * @retval None
+  */
+static void SYNTH_RenderBlock(SYNTH_Object_t *pSynth, uint32_t frames)
+{
+  uint32_t pos = 0;
+  uint32_t end;
+  uint32_t tail;
+  int32_t  delta;
+  uint8_t  dirty;
+#if (SYNTH_MAX_LFOS > 0U)
+  int32_t  gain = pSynth->ModGain;
+  int32_t  step;
+  uint32_t i;
+#endif
+
+  memset(pSynth->MixBuffer, 0, frames * sizeof(int32_t));
+
+#if (SYNTH_MAX_LFOS > 0U)
+  dirty = SYNTH_ModulateBlock(pSynth, frames) ? SYNTH_VOICE_DIRTY_PITCH : 0U;
+  dirty |= SYNTH_RefreshBlock(pSynth);
+#else
+  dirty = SYNTH_RefreshBlock(pSynth);
+#endif
+
+#if (SYNTH_USE_DUAL_CORE == 1U)
+  (void)pos;
+  (void)end;
+  (void)tail;
+  (void)delta;
+  SYNTH_RenderDual(pSynth, frames, dirty);
+#else
+  SYNTH_PrepareVoices(pSynth, frames, dirty, 0, 1);
+
+  while (pos < frames)
+  {
+    end  = frames;
+    tail = pSynth->EventTail;
+
+    while (tail != pSynth->EventHead)
+    {
+      SYNTH_Event_t *event = &pSynth->Events[tail & (SYNTH_EVENT_QUEUE_SIZE - 1U)];
+
+      delta = (int32_t)(event->Time - (pSynth->SampleClock + pos));
+      if (delta > 0)
+      {
+        if ((uint32_t)delta < (frames - pos))
+        {
+          end = pos + (uint32_t)delta;
+        }
+        break;
+      }
+
+      SYNTH_ApplyEvent(pSynth, event, frames - pos);
+
+      /* Slot is consumed before it is handed back to the producer */
+      SYNTH_MEMORY_BARRIER();
+      pSynth->EventTail = ++tail;
+    }
+
+    SYNTH_RenderVoices(pSynth, &pSynth->MixBuffer[pos], SYNTH_VOICE_SCRATCH(pSynth),
+                       end - pos, 0, 1);
+    pos = end;
+  }
+#endif
+
+#if (SYNTH_MAX_LFOS > 0U)
+  /* Amplitude modulation is shared by every voice, so it ramps the summed
+     voices once instead of each voice level */
+  if ((gain != 32768) || (pSynth->ModGain != 32768))
+  {
+    step  = ((pSynth->ModGain - gain) * 32768) / (int32_t)frames;
+    gain <<= 15;
+    for (i = 0; i < frames; i++)
+    {
+      pSynth->MixBuffer[i] = (int32_t)(((int64_t)pSynth->MixBuffer[i] * gain) >> 30);
+      gain += step;
+    }
+  }
+#endif
+
+#if (SYNTH_USE_FILTER == 1U)
+  if (pSynth->MasterFilter.Enable)
+  {
+    SYNTH_BiquadDF1(pSynth->MasterState, pSynth->MasterCoeffs, pSynth->MixBuffer, frames);
+  }
+#endif
+
+#if SYNTH_USE_FX
+  SYNTH_FxProcess(&pSynth->Fx, pSynth->MixBuffer, frames, pSynth->Ctx.SampleRate);
+#endif
+
+#if (SYNTH_MAX_CLIPS > 0U)
+  pSynth->ClipsMixed = SYNTH_MixClips(pSynth, frames);
+#endif
+#if (SYNTH_USE_USB_INPUT == 1U)
+  pSynth->ClipsMixed = SYNTH_MixUsb(pSynth, frames, pSynth->ClipsMixed);
+#endif
+}
+
+/**
+  * @brief  Advance the envelopes and raise the dirty bits of active voices
+  * @param  pSynth  Pointer to Synth object
+  * @param  frames  Number of frames about to be rendered
+  * @param  dirty   SYNTH_VOICE_DIRTY_xxx bits to raise
+  * @param  first   First voice slot
+  * @param  stride  Slot step, 2 when the cores split the pool
+  * @retval None
+  */
+static void SYNTH_PrepareVoices(SYNTH_Object_t *pSynth, uint32_t frames, uint8_t dirty,
+                                uint32_t first, uint32_t stride)
+{
+  uint32_t i;
+
+  for (i = first; i < SYNTH_MAX_VOICES; i += stride)
+  {
+    if (pSynth->Voices[i].Active)
+    {
+      SYNTH_EnvelopeBlock(pSynth, &pSynth->Voices[i], frames);
+      pSynth->Voices[i].Dirty |= dirty;
+    }
+  }
+}
+
+/**
+  * @brief  Accumulate active voices into the mix accumulator
+  * @param  pSynth   Pointer to Synth object
+  * @param  mix      Pointer to mono accumulator
+  * @param  scratch  Block for filtered voices, one per rendering core
+  * @param  frames   Number of frames to render
+  * @param  first    First voice slot
+  * @param  stride   Slot step, 2 when the cores split the pool
+  * @retval None
+  */
+static void SYNTH_RenderVoices(SYNTH_Object_t *pSynth, int32_t *mix, int32_t *scratch,
+                               uint32_t frames, uint32_t first, uint32_t stride)
+{
+  int32_t  *dst = mix;
+  uint32_t i;
+#if (SYNTH_USE_FILTER == 1U)
+  uint32_t j;
+
+  /* Filtered voices go through a scratch block before being summed */
+  if (pSynth->VoiceFilter.Enable)
+  {
+    dst = scratch;
+  }
+#else
+  (void)scratch;
+#endif
+
+  for (i = first; i < SYNTH_MAX_VOICES; i += stride)
+  {
+    if (pSynth->Voices[i].Active == 0U)
+    {
+      continue;
+    }
+
+    if (pSynth->Voices[i].Dirty != 0U)
+    {
+      SYNTH_RefreshVoice(pSynth, &pSynth->Voices[i]);
+    }
+
+#if (SYNTH_USE_FILTER == 1U)
+    if (dst != mix)
+    {
+      memset(dst, 0, frames * sizeof(int32_t));
+    }
+#endif
+
+#if (SYNTH_MAX_SAMPLERS > 0U)
+    if (pSynth->Voices[i].Sampler != NULL)
+    {
+      SYNTH_RenderSampleVoice(&pSynth->Voices[i], dst, frames);
+    }
+    else
+#endif
+    if ((pSynth->Voices[i].Waveform == SYNTH_WAVEFORM_SAW_BL) ||
+        (pSynth->Voices[i].Waveform == SYNTH_WAVEFORM_SQUARE_BL))
+    {
+      SYNTH_RenderBlepVoice(&pSynth->Voices[i], dst, frames);
+    }
+    else
+    {
+      SYNTH_RenderVoice(&pSynth->Voices[i], dst, frames);
+    }
+
+#if (SYNTH_USE_FILTER == 1U)
+    if (dst != mix)
+    {
+      SYNTH_BiquadDF1(pSynth->Voices[i].FilterState, pSynth->Voices[i].FilterCoeffs,
+                      dst, frames);
+      for (j = 0; j < frames; j++)
+      {
+        mix[j] += dst[j];
+      }
+    }
+#endif
+  }
+}
+
+#if (SYNTH_USE_DUAL_CORE == 1U)
+/**
+  * @brief  Render one block on both cores
+  * @note   Events due within the block are applied at its start, so both
+  *         cores render it whole from one voice snapshot. The second core
+  *         takes the odd slots, which the ascending voice allocation keeps
+  *         balanced with the even ones, and advances their envelopes
+  *         itself. Until it acknowledges a block the odd slots and the
+  *         events are left alone: a block is waited for once more before
+  *         the next, and while it stays overdue only the even slots render
+  *         and the dirty bits of the odd ones are held back for it.
+  * @param  pSynth  Pointer to Synth object
+  * @param  frames  Number of frames, at most SYNTH_STREAM_BLOCK_SIZE
+  * @param  dirty   SYNTH_VOICE_DIRTY_xxx bits to raise on every voice
+  * @retval None
+  */
+static void SYNTH_RenderDual(SYNTH_Object_t *pSynth, uint32_t frames, uint8_t dirty)
+{
+  uint32_t tail = pSynth->EventTail;
+  uint32_t spin = SYNTH_DUAL_CORE_TIMEOUT;
+  uint32_t seq = pSynth->SubRequest;
+  uint32_t i;
+
+  while ((pSynth->SubDone != seq) && (spin > 0U))
+  {
+    spin--;
+  }
+
+  if (pSynth->SubDone != seq)
+  {
+    SYNTH_STATS_INC(pSynth, SecondaryLate);
+    pSynth->SubMissed = 1;
+    pSynth->SubHeld  |= dirty;
+    SYNTH_PrepareVoices(pSynth, frames, dirty, 0, 2);
+    SYNTH_RenderVoices(pSynth, pSynth->MixBuffer, SYNTH_VOICE_SCRATCH(pSynth), frames, 0, 2);
+    return;
+  }
+
+  /* Odd voices as the second core left them */
+  SYNTH_MEMORY_BARRIER();
+
+  while (tail != pSynth->EventHead)
+  {
+    SYNTH_Event_t *event = &pSynth->Events[tail & (SYNTH_EVENT_QUEUE_SIZE - 1U)];
+
+    if ((int32_t)(event->Time - pSynth->SampleClock) >= (int32_t)frames)
+    {
+      break;
+    }
+
+    /* Envelopes of new and released notes advance with the rest below */
+    SYNTH_ApplyEvent(pSynth, event, 0);
+    SYNTH_MEMORY_BARRIER();
+    pSynth->EventTail = ++tail;
+  }
+
+  /* Voices are final for this block before the second core sees it */
+  pSynth->SubFrames = frames;
+  pSynth->SubDirty  = dirty | pSynth->SubHeld;
+  pSynth->SubHeld   = 0;
+  SYNTH_MEMORY_BARRIER();
+  seq++;
+  pSynth->SubRequest = seq;
+  SYNTH_MEMORY_BARRIER();
+  SYNTH_HSEM_NOTIFY(SYNTH_HSEM_RENDER);
+
+  SYNTH_PrepareVoices(pSynth, frames, dirty, 0, 2);
+  SYNTH_RenderVoices(pSynth, pSynth->MixBuffer, SYNTH_VOICE_SCRATCH(pSynth), frames, 0, 2);
+
+  spin = SYNTH_DUAL_CORE_TIMEOUT;
+  while ((pSynth->SubDone != seq) && (spin > 0U))
+  {
+    spin--;
+  }
+
+  /* Too late for this block: its odd voices are dropped, and the second
+     core keeps them until it catches up */
+  if (pSynth->SubDone != seq)
+  {
+    SYNTH_STATS_INC(pSynth, SecondaryLate);
+    pSynth->SubMissed = 1;
+    return;
+  }
+
+  SYNTH_MEMORY_BARRIER();
+  for (i = 0; i < frames; i++)
+  {
+    pSynth->MixBuffer[i] += pSynth->SubMix[i];
+  }
+}
+#endif /* SYNTH_USE_DUAL_CORE */
+
+#if (SYNTH_MAX_CLIPS > 0U)
+/**
+  * @brief  Sum the playing clips for one block
+  * @note   Mono output mixes straight into the voice accumulator, stereo
+  *         into ClipBuffer. A finished clip frees its slot and reports
+  *         through the SYNTH_TxCallback_t.
+  * @param  pSynth  Pointer to Synth object
+  * @param  frames  Number of frames, at most SYNTH_STREAM_BLOCK_SIZE
+  * @retval 1 if ClipBuffer was written
+  */
+static uint8_t SYNTH_MixClips(SYNTH_Object_t *pSynth, uint32_t frames)
+{
+  SYNTH_Clip_t *clip;
+  const SYNTH_Sample_t *src;
+  int32_t  *acc;
+  int32_t  gain;
+  uint8_t  mixed = 0;
+  uint32_t count;
+  uint32_t c;
+  uint32_t i;
+
+#if (SYNTH_CHANNELS == 2U)
+  acc = pSynth->ClipBuffer;
+#else
+  acc = pSynth->MixBuffer;
+#endif
+
+  for (c = 0; c < SYNTH_MAX_CLIPS; c++)
+  {
+    clip = &pSynth->Clips[c];
+    if (clip->Active == 0U)
+    {
+      continue;
+    }
+
+#if (SYNTH_CHANNELS == 2U)
+    if (mixed == 0U)
+    {
+      memset(acc, 0, frames * SYNTH_CHANNELS * sizeof(int32_t));
+    }
+#endif
+    mixed = 1;
+
+    count = clip->Frames - clip->Pos;
+    count = (count > frames) ? frames : count;
+    src   = &clip->Data[clip->Pos * SYNTH_CHANNELS];
+    gain  = clip->Gain;
+
+    for (i = 0; i < (count * SYNTH_CHANNELS); i++)
+    {
+      acc[i] += (int32_t)(((int64_t)src[i] * gain) >> SYNTH_CLIP_SHIFT);
+    }
+
+    clip->Pos += count;
+    if (clip->Pos >= clip->Frames)
+    {
+      clip->Active = 0;
+
+      if (pSynth->TxCallback)
+      {
+        pSynth->TxCallback(pSynth);
+      }
+    }
+  }
+
+#if (SYNTH_CHANNELS == 2U)
+  return mixed;
+#else
+  (void)mixed;
+  return 0;
+#endif
+}
+#endif /* SYNTH_MAX_CLIPS */
+
+#if (SYNTH_USE_USB_INPUT == 1U)
+/**
+  * @brief  Sum one block of the USB input ring onto the clip bus
+  * @note   Reads the ring in place, in at most two runs split at the
+  *         writer's wrap point. Also tracks the fill for the feedback value.
+  * @param  pSynth  Pointer to Synth object
+  * @param  frames  Number of frames, at most SYNTH_STREAM_BLOCK_SIZE
+  * @param  mixed   1 if ClipBuffer already holds this block
+  * @retval 1 if ClipBuffer was written
+  */
+static uint8_t SYNTH_MixUsb(SYNTH_Object_t *pSynth, uint32_t frames, uint8_t mixed)
+{
+  const SYNTH_Sample_t *src;
+  int32_t  *acc;
+  int32_t  gain = pSynth->UsbGain;
+  uint32_t fill;
+  uint32_t count;
+  uint32_t run;
+  uint32_t pos;
+  uint32_t read;
+  uint32_t i;
+
+  if (pSynth->UsbActive == 0U)
+  {
+    return mixed;
+  }
+
+  fill = pSynth->UsbHead - pSynth->UsbTail;
+  SYNTH_MEMORY_BARRIER();
+  pSynth->UsbFill += (uint32_t)((int32_t)((fill << 8) - pSynth->UsbFill) >> 4);
+
+  if (pSynth->UsbPrimed == 0U)
+  {
+    if (fill < (SYNTH_USB_RING_FRAMES / 2U))
+    {
+      return mixed;
+    }
+    pSynth->UsbPrimed = 1;
+  }
+
+  count = frames;
+  if (fill < frames)
+  {
+    SYNTH_STATS_INC(pSynth, UsbUnderruns);
+    pSynth->UsbPrimed = 0;
+    count = fill;
+  }
+
+#if (SYNTH_CHANNELS == 2U)
+  acc = pSynth->ClipBuffer;
+  if ((mixed == 0U) && (count > 0U))
+  {
+    memset(acc, 0, frames * SYNTH_CHANNELS * sizeof(int32_t));
+    mixed = 1;
+  }
+#else
+  acc = pSynth->MixBuffer;
+#endif
+
+  for (pos = 0; pos < count; pos += run)
+  {
+    read = (pSynth->UsbTail + pos) & (SYNTH_USB_RING_FRAMES - 1U);
+    run  = SYNTH_USB_RING_FRAMES - read;
+    run  = (run > (count - pos)) ? (count - pos) : run;
+    src  = &pSynth->UsbRing[read * SYNTH_CHANNELS];
+
+    for (i = 0; i < (run * SYNTH_CHANNELS); i++)
+    {
+      acc[(pos * SYNTH_CHANNELS) + i] += (int32_t)(((int64_t)src[i] * gain) >> SYNTH_CLIP_SHIFT);
+    }
+  }
+
+  /* Frames are read before the writer may reuse them */
+  SYNTH_MEMORY_BARRIER();
+  pSynth->UsbTail += count;
+
+  return mixed;
+}
+#endif /* SYNTH_USE_USB_INPUT */
+
+/**
+  * @brief  Apply one dequeued event to the voice pool
+  * @param  pSynth  Pointer to Synth object
+  * @param  event   Pointer to event
+  * @param  frames  Frames left in the block from the event on, 0 when the
+  *                 caller advances the envelopes afterwards
+  * @retval None
+  */
+static void SYNTH_ApplyEvent(SYNTH_Object_t *pSynth, const SYNTH_Event_t *event,
+                             uint32_t frames)
+{
+  SYNTH_Voice_t *voice;
+  uint32_t i;
+
+  switch (event->Type)
+  {
+    case SYNTH_EVENT_NOTE_ON:
+      voice = SYNTH_AllocVoice(pSynth, event->Note);
+
+      /* A retriggered or stolen voice keeps its phase and level, the
+         attack ramps from there instead of clicking back to zero */
+      if (voice->Active == 0U)
+      {
+        voice->Phase = 0;
+        voice->Level = 0;
+#if (SYNTH_USE_FILTER == 1U)
+        memset(voice->FilterState, 0, sizeof(voice->FilterState));
+#endif
+      }
+
+#if (SYNTH_MAX_SAMPLERS > 0U)
+      /* Samples always restart, the step follows from the increment */
+      voice->Sampler = NULL;
+      if (event->Waveform >= SYNTH_WAVEFORM_SAMPLER)
+      {
+        voice->Sampler   = &pSynth->Samplers[event->Waveform - SYNTH_WAVEFORM_SAMPLER];
+        voice->SamplePos = 0;
+        voice->Phase     = 0;
+      }
+#endif
+
+      voice->Waveform = event->Waveform;
+      voice->Table    = pSynth->Wavetables[event->Waveform];
+      SYNTH_SetVoiceInc(voice, SYNTH_NoteToPhaseInc(pSynth, event->Note));
+      voice->Peak     = (int32_t)event->Velocity << 23;
+      voice->EnvStage = SYNTH_ENV_ATTACK;
+      voice->Note     = event->Note;
+      voice->Age      = pSynth->VoiceAge++;
+      voice->Active   = 1;
+      if (frames != 0U)
+      {
+        SYNTH_EnvelopeBlock(pSynth, voice, frames);
+      }
+      voice->Dirty   |= SYNTH_VOICE_DIRTY_FILTER;
+
+      pSynth->LastVoice = voice;
+      break;
+
+    case SYNTH_EVENT_NOTE_OFF:
+      for (i = 0; i < SYNTH_MAX_VOICES; i++)
+      {
+        voice = &pSynth->Voices[i];
+
+        if (voice->Active && (voice->Note == event->Note) &&
+            (voice->EnvStage < SYNTH_ENV_RELEASE))
+        {
+          voice->EnvStage = SYNTH_ENV_RELEASE;
+          if (frames != 0U)
+          {
+            SYNTH_EnvelopeBlock(pSynth, voice, frames);
+          }
+        }
+      }
+      break;
+
+    case SYNTH_EVENT_FREQUENCY:
+      if ((pSynth->LastVoice != NULL) && pSynth->LastVoice->Active)
+      {
+        SYNTH_SetVoiceInc(pSynth->LastVoice, SYNTH_FrequencyToPhaseInc(pSynth, event->Frequency));
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+#if (SYNTH_MAX_LFOS > 0U)
+/**
+  * @brief  Advance the LFOs by one block and evaluate the modulation matrix
+  * @note   Targets are held for the block except the master gain, which
+  *         SYNTH_RenderBlock ramps from the previous end point.
+  * @param  pSynth  Pointer to Synth object
+  * @param  frames  Number of frames in the block
+  * @retval 1 if voice increments must follow a new pitch ratio
+  */
+static uint8_t SYNTH_ModulateBlock(SYNTH_Object_t *pSynth, uint32_t frames)
+{
+  const SYNTH_ModRoute_t *route;
+  int32_t  value[SYNTH_MAX_LFOS];
+  int32_t  cents  = 0;
+  int32_t  cutoff = 0;
+  int32_t  gain   = 32768;
+  int32_t  v;
+  uint32_t ratio  = 1UL << 30;
+  float    r;
+  uint32_t i;
+
+  for (i = 0; i < SYNTH_MAX_LFOS; i++)
+  {
+    value[i] = pSynth->Wavetables[pSynth->Lfos[i].Shape]
+               [pSynth->LfoPhase[i] >> (32U - SYNTH_WAVETABLE_BITS)];
+    pSynth->LfoPhase[i] += pSynth->LfoInc[i] * frames;
+  }
+
+  for (i = 0; i < SYNTH_MOD_SLOTS; i++)
+  {
+    route = &pSynth->ModRoutes[i];
+    v     = value[route->Source];
+
+    switch (route->Target)
+    {
+      case SYNTH_MOD_PITCH:
+        cents += (route->Depth * v) >> 15;
+        break;
+
+      case SYNTH_MOD_AMP:
+        /* Full depth swings from unity at the LFO peak to silence */
+        v     = (route->Depth < 0) ? -v : v;
+        v     = 32768 - ((((route->Depth < 0) ? -route->Depth : route->Depth) *
+                          (32768 - v)) / 200);
+        gain  = (gain * v) >> 15;
+        break;
+
+      case SYNTH_MOD_CUTOFF:
+        cutoff += (route->Depth * v) >> 15;
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  /* Summed routes stay within the range, whose top end rounds to 4.0 and
+     is held just below it, the largest Q30 ratio */
+  if (cents != 0)
+  {
+    cents = (cents > SYNTH_MOD_PITCH_RANGE) ? SYNTH_MOD_PITCH_RANGE : cents;
+    cents = (cents < -SYNTH_MOD_PITCH_RANGE) ? -SYNTH_MOD_PITCH_RANGE : cents;
+    r     = expf((float)cents * 0.00057762265f) * 1073741824.0f;
+    ratio = (r < 4294967040.0f) ? (uint32_t)r : 0xFFFFFF00UL;
+  }
+
+  if (cutoff != pSynth->ModCutoff)
+  {
+    pSynth->ModCutoff = cutoff;
+    SYNTH_DIRTY_RAISE(pSynth, SYNTH_DIRTY_VOICE_FILTER | SYNTH_DIRTY_MASTER_FILTER);
+  }
+  pSynth->ModGain = gain;
+
+  /* New notes already pick up an unchanged ratio in SYNTH_RefreshVoice */
+  if (ratio == pSynth->PitchRatio)
+  {
+    return 0;
+  }
+
+  pSynth->PitchRatio = ratio;
+  return 1;
+}
+
+/**
+  * @brief  Refresh the per-frame LFO increments
+  * @param  pSynth  Pointer to Synth object
+  * @retval None
+  */
+static void SYNTH_UpdateLfoIncs(SYNTH_Object_t *pSynth)
+{
+  uint32_t i;
+
+  for (i = 0; i < SYNTH_MAX_LFOS; i++)
+  {
+    pSynth->LfoInc[i] = (pSynth->Ctx.SampleRate != 0U) ?
+                        (uint32_t)(((uint64_t)pSynth->Lfos[i].Rate << 32) /
+                                   (100ULL * pSynth->Ctx.SampleRate)) : 0U;
+  }
+}
+#endif /* SYNTH_MAX_LFOS */
+
+/**
+  * @brief  Switch to the loaded preset image
+  * @note   Runs between blocks, so no block mixes old and new settings.
+  * @param  pSynth  Pointer to Synth object
+  * @retval None
+  */
+static void SYNTH_ApplyPreset(SYNTH_Object_t *pSynth)
+{
+  const SYNTH_Preset_t *preset = &pSynth->Preset;
+
+  pSynth->Envelope = preset->Envelope;
+  SYNTH_UpdateEnvelope(pSynth);
+#if (SYNTH_USE_FILTER == 1U)
+  (void)SYNTH_SetFilter(pSynth, SYNTH_FILTER_VOICE, &preset->VoiceFilter);
+  (void)SYNTH_SetFilter(pSynth, SYNTH_FILTER_MASTER, &preset->MasterFilter);
+#endif
+
+  pSynth->PresetPending = 0;
+}
+
+/**
+  * @brief  Advance a voice envelope over the frames about to be rendered
+  * @note   Computes the level the current segment reaches after frames
+  *         samples (linear attack, exponential decay and release) and the
+  *         per-sample step to get there, so the sample loop only adds. A
+  *         short render or a block split at an event scales the per-block
+  *         coefficients down to the frames actually covered.
+  *         A voice whose release has reached silence is freed.
+  * @param  pSynth  Pointer to Synth object
+  * @param  voice   Pointer to voice
+  * @param  frames  Frames covered, 1 to SYNTH_STREAM_BLOCK_SIZE
+  * @retval None
+  */
+static void SYNTH_EnvelopeBlock(SYNTH_Object_t *pSynth, SYNTH_Voice_t *voice,
+                                uint32_t frames)
+{
+  int32_t level = voice->Level;
+  int32_t target;
+  int32_t end;
+  int32_t inc;
+  int32_t coef;
+
+  switch (voice->EnvStage)
+  {
+    case SYNTH_ENV_ATTACK:
+      inc = (int32_t)(((int64_t)voice->Peak * pSynth->EnvAttackInc) >> 30);
+      if (frames != SYNTH_STREAM_BLOCK_SIZE)
+      {
+        inc = (int32_t)(((int64_t)inc * frames) / SYNTH_STREAM_BLOCK_SIZE);
+      }
+      end = level + inc;
+      if (end >= voice->Peak)
+      {
+        end = voice->Peak;
+        voice->EnvStage = SYNTH_ENV_DECAY;
+      }
+      break;
+
+    case SYNTH_ENV_DECAY:
+      target = (int32_t)(((int64_t)voice->Peak * pSynth->EnvSustain) >> 15);
+      coef   = (frames == SYNTH_STREAM_BLOCK_SIZE) ? pSynth->EnvDecayCoef :
+               SYNTH_PowQ30(pSynth->EnvDecayStep, frames);
+      end    = target + (int32_t)(((int64_t)(level - target) * coef) >> 30);
+      if ((end - target) < SYNTH_ENV_SILENCE)
+      {
+        end = target;
+        voice->EnvStage = SYNTH_ENV_SUSTAIN;
+      }
+      break;
+
+    case SYNTH_ENV_SUSTAIN:
+      /* Follows sustain changes made while the note is held */
+      end = (int32_t)(((int64_t)voice->Peak * pSynth->EnvSustain) >> 15);
+      break;
+
+    case SYNTH_ENV_RELEASE:
+      coef = (frames == SYNTH_STREAM_BLOCK_SIZE) ? pSynth->EnvReleaseCoef :
+             SYNTH_PowQ30(pSynth->EnvReleaseStep, frames);
+      end  = (int32_t)(((int64_t)level * coef) >> 30);
+      if (end < SYNTH_ENV_SILENCE)
+      {
+        end = 0;
+        voice->EnvStage = SYNTH_ENV_IDLE;
+      }
+      break;
+
+    case SYNTH_ENV_IDLE:
+    default:
+      voice->Level     = 0;
+      voice->LevelStep = 0;
+      voice->Active    = 0;
+      return;
+  }
+
+  voice->LevelStep = (end - level) / (int32_t)frames;
+}
+
+/**
+  * @brief  Raise a Q30 coefficient to an integer power
+  * @note   Square and multiply, at most two products per bit of n.
+  * @param  coef  Q30 value, 0 to 1.0
+  * @param  n     Exponent
+  * @retval Q30 coef^n
+  */
+static int32_t SYNTH_PowQ30(int32_t coef, uint32_t n)
+{
+  int32_t result = (int32_t)(1UL << 30);
+
+  while (n != 0U)
+  {
+    if (n & 1U)
+    {
+      result = (int32_t)(((int64_t)result * coef) >> 30);
+    }
+    coef = (int32_t)(((int64_t)coef * coef) >> 30);
+    n >>= 1;
+  }
+
+  return result;
+}
+
+/**
+  * @brief  Switch to a new sample rate and retune everything derived from it
+  * @note   Single place where rate dependent state is refreshed: note and
+  *         Hz increment bases, envelope coefficients, the filter table and
+  *         the increments of sounding voices, rescaled to keep their pitch.
+  * @param  pSynth       Pointer to Synth object
+  * @param  sample_rate  New sample rate (Hz)
+  * @retval None
+  */
+static void SYNTH_ApplySampleRate(SYNTH_Object_t *pSynth, uint32_t sample_rate)
+{
+  uint32_t old = pSynth->Ctx.SampleRate;
+  uint64_t inc;
+  uint32_t i;
+
+  pSynth->Ctx.SampleRate = sample_rate;
+  SYNTH_UpdatePhaseIncs(pSynth);
+  SYNTH_UpdateEnvelope(pSynth);
+#if (SYNTH_USE_FILTER == 1U)
+  SYNTH_UpdateFilterTable(pSynth);
+#endif
+#if (SYNTH_MAX_LFOS > 0U)
+  SYNTH_UpdateLfoIncs(pSynth);
+#endif
+  SYNTH_DIRTY_RAISE(pSynth, SYNTH_DIRTY_ALL);
+
+  if ((old != 0U) && (old != sample_rate))
+  {
+    for (i = 0; i < SYNTH_MAX_VOICES; i++)
+    {
+      if (pSynth->Voices[i].Active)
+      {
+        inc = ((uint64_t)pSynth->Voices[i].BaseInc * old) / sample_rate;
+        SYNTH_SetVoiceInc(&pSynth->Voices[i],
+                          (inc >= 0x80000000ULL) ? 0x80000000UL : (uint32_t)inc);
+      }
+    }
+  }
+
+  if (pSynth->IO.SetSampleRate)
+  {
+    pSynth->IO.SetSampleRate(sample_rate);
+  }
+}
+
+/**
+  * @brief  Derive the per-block envelope coefficients
+  * @note   The per-sample decay and release multipliers serve blocks
+  *         shorter than SYNTH_STREAM_BLOCK_SIZE.
+  * @param  pSynth  Pointer to Synth object
+  * @retval None
+  */
+static void SYNTH_UpdateEnvelope(SYNTH_Object_t *pSynth)
+{
+  float block = (float)SYNTH_STREAM_BLOCK_SIZE;
+  float rate  = (float)pSynth->Ctx.SampleRate / 1000.0f;
+  float samples;
+
+  /* Linear attack, at least one block long */
+  samples = (float)pSynth->Envelope.Attack * rate;
+  pSynth->EnvAttackInc = (samples > block) ?
+                         (int32_t)((block / samples) * 1073741824.0f) : (int32_t)(1UL << 30);
+
+  /* Exponential segments fall by 60 dB (ln 1000) over the set time */
+  samples = (float)pSynth->Envelope.Decay * rate;
+  pSynth->EnvDecayCoef = (samples > 0.0f) ?
+                         (int32_t)(expf(-6.9077553f * block / samples) * 1073741824.0f) : 0;
+  pSynth->EnvDecayStep = (samples > 0.0f) ?
+                         (int32_t)(expf(-6.9077553f / samples) * 1073741824.0f) : 0;
+
+  samples = (float)pSynth->Envelope.Release * rate;
+  pSynth->EnvReleaseCoef = (samples > 0.0f) ?
+                           (int32_t)(expf(-6.9077553f * block / samples) * 1073741824.0f) : 0;
+  pSynth->EnvReleaseStep = (samples > 0.0f) ?
+                           (int32_t)(expf(-6.9077553f / samples) * 1073741824.0f) : 0;
+
+  pSynth->EnvSustain = ((int32_t)pSynth->Envelope.Sustain * 32767) / 100;
+}
+
+#if (SYNTH_USE_FILTER == 1U)
+/**
+  * @brief  Tabulate cos and sin of the cutoff for every MIDI note
+  * @note   Cutoffs above 0.45 fs are clamped to keep the filter stable.
+  * @param  pSynth  Pointer to Synth object
+  * @retval None
+  */
+static void SYNTH_UpdateFilterTable(SYNTH_Object_t *pSynth)
+{
+  float    rate = (float)pSynth->Ctx.SampleRate;
+  float    freq;
+  float    w;
+  uint32_t n;
+
+  for (n = 0; n < 128U; n++)
+  {
+    /* MIDI 60-71 is the octave of SynthOctaveFreq */
+    freq = ldexpf(SynthOctaveFreq[n % 12U], (int)(n / 12U) - 5);
+    if (freq > (0.45f * rate))
+    {
+      freq = 0.45f * rate;
+    }
+
+    w = 6.2831853f * freq / rate;
+    pSynth->FilterCos[n] = (int32_t)(cosf(w) * 1073741824.0f);
+    pSynth->FilterSin[n] = (int32_t)(sinf(w) * 1073741824.0f);
+  }
+}
+
+/**
+  * @brief  Derive low-pass biquad coefficients from the note table
+  * @note   RBJ cookbook low-pass in Q30, one division per call, signs in
+  *         the CMSIS DF1 convention where the feedback terms are added.
+  * @param  pSynth  Pointer to Synth object
+  * @param  note    Cutoff as a MIDI note, clamped to 0-127
+  * @param  damp    Q16 1/(2Q)
+  * @param  coeffs  Pointer to the five coefficients to update
+  * @retval None
+  */
+static void SYNTH_FilterCoeffs(SYNTH_Object_t *pSynth, int32_t note, int32_t damp,
+                               int32_t *coeffs)
+{
+  int32_t cs;
+  int32_t alpha;
+  int32_t inv;
+  int32_t b1;
+
+  note  = (note < 0) ? 0 : ((note > 127) ? 127 : note);
+  cs    = pSynth->FilterCos[note];
+  alpha = (int32_t)(((int64_t)pSynth->FilterSin[note] * damp) >> 16);
+  inv   = (int32_t)(((int64_t)1 << 60) / ((int64_t)(1L << 30) + alpha));
+  b1    = (int32_t)(((int64_t)((1L << 30) - cs) * inv) >> 30);
+
+  coeffs[0] = b1 >> 1;
+  coeffs[1] = b1;
+  coeffs[2] = b1 >> 1;
+  coeffs[3] = SYNTH_SSAT32(((int64_t)cs * inv) >> 29);
+  coeffs[4] = -(int32_t)(((int64_t)((1L << 30) - alpha) * inv) >> 30);
+}
+#endif /* SYNTH_USE_FILTER */
+
+/**
+  * @brief  Recompute the note and frequency phase increment bases
+  * @note   Only place a division by the sample rate happens.
+  * @param  pSynth  Pointer to Synth object
+  * @retval None
+  */
+static void SYNTH_UpdatePhaseIncs(SYNTH_Object_t *pSynth)
+{
+  uint32_t i;
+
+  pSynth->PhaseIncPerHz = (pSynth->Ctx.SampleRate != 0U) ?
+                          (4294967296.0f / (float)pSynth->Ctx.SampleRate) : 0.0f;
+
+  for (i = 0; i < 12U; i++)
+  {
+    pSynth->NoteInc[i] = SYNTH_FrequencyToPhaseInc(pSynth, SynthOctaveFreq[i]);
+  }
+}
+
+/**
+  * @brief  Convert a frequency to a phase increment at the current rate
+  * @param  pSynth  Pointer to Synth object
+  * @param  frequency  Frequency in Hz
+  * @retval Phase increment, clamped to Nyquist
+  */
+static uint32_t SYNTH_FrequencyToPhaseInc(SYNTH_Object_t *pSynth, float frequency)
+{
+  float inc = frequency * pSynth->PhaseIncPerHz;
+
+  if (inc >= 2147483648.0f)
+  {
+    return 0x80000000UL;
+  }
+
+  return (uint32_t)inc;
+}
+
+/**
+  * @brief  Convert a MIDI note to a phase increment with integer shifts
+  * @param  pSynth  Pointer to Synth object
+  * @param  note  MIDI note number (0-127)
+  * @retval Phase increment, clamped to Nyquist
+  */
+static uint32_t SYNTH_NoteToPhaseInc(SYNTH_Object_t *pSynth, uint8_t note)
+{
+  uint32_t octave = note / 12U;
+  uint32_t inc    = pSynth->NoteInc[note % 12U];
+
+  if (octave < 5U)
+  {
+    return inc >> (5U - octave);
+  }
+
+  octave -= 5U;
+  if (inc >= (0x80000000UL >> octave))
+  {
+    return 0x80000000UL;
+  }
+
+  return inc << octave;
+}
+
+/**
+  * @brief  Set a voice base phase increment
+  * @note   The increment itself is derived when the voice next renders.
+  * @param  voice   Pointer to voice
+  * @param  inc     Phase increment before pitch modulation
+  * @retval None
+  */
+static void SYNTH_SetVoiceInc(SYNTH_Voice_t *voice, uint32_t inc)
+{
+  voice->BaseInc = inc;
+  voice->Dirty  |= SYNTH_VOICE_DIRTY_PITCH;
+}
+
+/**
+  * @brief  Recompute the derived object state whose inputs changed
+  * @note   Runs at each block boundary; with nothing dirty it is one load.
+  *         Setters only raise SYNTH_DIRTY_xxx bits. The bits are taken in
+  *         one atomic exchange, a bit raised after it is served at the next
+  *         block.
+  * @param  pSynth  Pointer to Synth object
+  * @retval SYNTH_VOICE_DIRTY_xxx bits to raise on every sounding voice
+  */
+static uint8_t SYNTH_RefreshBlock(SYNTH_Object_t *pSynth)
+{
+  uint8_t dirty;
+
+  if (pSynth->Dirty == 0U)
+  {
+    return 0;
+  }
+
+  dirty = SYNTH_DIRTY_TAKE(pSynth);
+
+  if (dirty & SYNTH_DIRTY_GAIN)
+  {
+    pSynth->GainTarget = SYNTH_TargetGain(pSynth);
+  }
+
+#if (SYNTH_USE_FILTER == 1U)
+  if (dirty & SYNTH_DIRTY_MASTER_FILTER)
+  {
+    SYNTH_FilterCoeffs(pSynth, pSynth->MasterFilter.Cutoff + SYNTH_MOD_CUTOFF_OFFSET(pSynth),
+                       pSynth->MasterFilterDamp, pSynth->MasterCoeffs);
+  }
+
+  return (dirty & SYNTH_DIRTY_VOICE_FILTER) ? SYNTH_VOICE_DIRTY_FILTER : 0U;
+#else
+  return 0;
+#endif
+}
+
+/**
+  * @brief  Recompute the derived voice state whose inputs changed
+  * @note   Called by the render loop on the core that owns the voice.
+  * @param  pSynth  Pointer to Synth object
+  * @param  voice   Pointer to voice
+  * @retval None
+  */
+static void SYNTH_RefreshVoice(SYNTH_Object_t *pSynth, SYNTH_Voice_t *voice)
+{
+  if (voice->Dirty & SYNTH_VOICE_DIRTY_PITCH)
+  {
+#if (SYNTH_MAX_LFOS > 0U)
+    SYNTH_TuneVoice(voice, pSynth->PitchRatio);
+#else
+    SYNTH_TuneVoice(voice, 1UL << 30);
+#endif
+  }
+
+#if (SYNTH_USE_FILTER == 1U)
+  if (voice->Dirty & SYNTH_VOICE_DIRTY_FILTER)
+  {
+    SYNTH_FilterCoeffs(pSynth, (int32_t)voice->Note + pSynth->VoiceFilter.Cutoff +
+                       SYNTH_MOD_CUTOFF_OFFSET(pSynth),
+                       pSynth->VoiceFilterDamp, voice->FilterCoeffs);
+  }
+#endif
+
+  voice->Dirty = 0;
+}
+
+/**
+  * @brief  Derive a voice phase increment from its base and a pitch ratio
+  * @note   The 64-bit division for the PolyBLEP reciprocal runs here, for
+  *         band-limited voices only, instead of per sample. A sampler
+  *         voice also derives its Q16.16 step through the slot.
+  * @param  voice  Pointer to voice
+  * @param  ratio  Q30 increment multiplier
+  * @retval None
+  */
+static void SYNTH_TuneVoice(SYNTH_Voice_t *voice, uint32_t ratio)
+{
+  uint64_t inc = ((uint64_t)voice->BaseInc * ratio) >> 30;
+  uint64_t recip;
+
+  if (inc > 0x80000000ULL)
+  {
+    inc = 0x80000000ULL;
+  }
+
+  voice->PhaseInc = (uint32_t)inc;
+
+  if ((voice->Waveform == SYNTH_WAVEFORM_SAW_BL) || (voice->Waveform == SYNTH_WAVEFORM_SQUARE_BL))
+  {
+    recip = (inc != 0U) ? ((1ULL << 47) / inc) : 0xFFFFFFFFULL;
+    voice->BlepRecip = (recip > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : (uint32_t)recip;
+  }
+
+#if (SYNTH_MAX_SAMPLERS > 0U)
+  if (voice->Sampler != NULL)
+  {
+    voice->SampleStep = (uint32_t)(((uint64_t)inc * voice->Sampler->Scale) >> 32);
+  }
+#endif
+}
+
+/**
+  * @brief  Check that a waveform identifier has a table or sampler loaded
+  * @param  pSynth       Pointer to Synth object
+  * @param  waveform_id  SYNTH_WAVEFORM_xxx identifier
+  * @retval 1 if notes can use the waveform
+  */
+static uint8_t SYNTH_WaveformLoaded(SYNTH_Object_t *pSynth, uint8_t waveform_id)
+{
+#if (SYNTH_MAX_SAMPLERS > 0U)
+  if ((waveform_id >= SYNTH_WAVEFORM_SAMPLER) && (waveform_id < SYNTH_WAVEFORM_COUNT))
+  {
+    return (pSynth->Samplers[waveform_id - SYNTH_WAVEFORM_SAMPLER].Desc != NULL) ? 1U : 0U;
+  }
+#endif
+
+  return ((waveform_id < SYNTH_WAVEFORM_SAMPLER) &&
+          (pSynth->Wavetables[waveform_id] != NULL)) ? 1U : 0U;
+}
+
+/**
+  * @brief  Pick a voice for a new note
+  * @note   A voice already playing the note is retriggered, then a free
+  *         voice is used, otherwise a releasing voice and then any voice is
+  *         stolen per SYNTH_VOICE_STEAL_POLICY.
+  * @param  pSynth  Pointer to Synth object
+  * @param  note  MIDI note number
+  * @retval Pointer to the selected voice
+  */
+static SYNTH_Voice_t *SYNTH_AllocVoice(SYNTH_Object_t *pSynth, uint8_t note)
+{
+  SYNTH_Voice_t *victim = &pSynth->Voices[0];
+  uint32_t i;
+
+  for (i = 0; i < SYNTH_MAX_VOICES; i++)
+  {
+    if (pSynth->Voices[i].Active && (pSynth->Voices[i].Note == note))
+    {
+      return &pSynth->Voices[i];
+    }
+  }
+
+  for (i = 0; i < SYNTH_MAX_VOICES; i++)
+  {
+    if (pSynth->Voices[i].Active == 0U)
+    {
+      return &pSynth->Voices[i];
+    }
+  }
+
+  for (i = 1; i < SYNTH_MAX_VOICES; i++)
+  {
+    SYNTH_Voice_t *voice = &pSynth->Voices[i];
+    uint8_t releasing = (voice->EnvStage == SYNTH_ENV_RELEASE) ? 1U : 0U;
+
+    /* Releasing voices go first, then the policy decides */
+    if (releasing != ((victim->EnvStage == SYNTH_ENV_RELEASE) ? 1U : 0U))
+    {
+      if (releasing)
+      {
+        victim = voice;
+      }
+      continue;
+    }
+
+#if (SYNTH_VOICE_STEAL_POLICY == SYNTH_STEAL_QUIETEST)
+    if ((voice->Level < victim->Level) ||
+        ((voice->Level == victim->Level) && (voice->Age < victim->Age)))
+#else
+    if (voice->Age < victim->Age)
+#endif
+    {
+      victim = voice;
+    }
+  }
+
+  SYNTH_STATS_INC(pSynth, VoiceSteals);
+  return victim;
+}
+
+/**
+  * @brief  Accumulate one voice into the mix buffer
+  * @note   Top phase bits index the table, the next 15 bits interpolate,
+  *         so the loop is a few integer ops per sample with no FPU use and
+  *         a single SMLAWB multiply-accumulate on DSP cores.
+  * @param  voice   Pointer to voice
+  * @param  mix     Pointer to mono accumulator
+  * @param  frames  Number of frames to render
+  * @retval None
+  */
+static void SYNTH_RenderVoice(SYNTH_Voice_t *voice, int32_t *mix, uint32_t frames)
+{
+  const int16_t *table = voice->Table;
+  uint32_t phase = voice->Phase;
+  uint32_t inc   = voice->PhaseInc;
+  int32_t  level = voice->Level;
+  int32_t  step  = voice->LevelStep;
+  uint32_t i;
+
+  for (i = 0; i < frames; i++)
+  {
+    uint32_t idx = phase >> (32U - SYNTH_WAVETABLE_BITS);
+    int32_t  s   = table[idx];
+
+#if (SYNTH_WAVETABLE_INTERPOLATION == 1U)
+    int32_t  next = table[(idx + 1U) & (SYNTH_WAVETABLE_SIZE - 1U)];
+    int32_t  frac = (int32_t)((phase >> (17U - SYNTH_WAVETABLE_BITS)) & 0x7FFFU);
+    s += ((next - s) * frac) >> 15;
+#endif
+
+    /* Q30 level to the SMLAWB operand, see SYNTH_MIX_EXTRA_BITS */
+    mix[i] = SYNTH_SMLAWB(level >> SYNTH_LEVEL_SHIFT, s, mix[i]);
+    level += step;
+    phase += inc;
+  }
+
+  voice->Phase = phase;
+  voice->Level = level;
+}
+
+/**
+  * @brief  PolyBLEP residual around a unit step at phase zero
+  * @param  t      Phase, full scale is one period
+  * @param  dt     Phase increment
+  * @param  recip  2^47 / dt
+  * @retval Q15 correction, zero away from the discontinuity
+  */
+static int32_t SYNTH_PolyBlep(uint32_t t, uint32_t dt, uint32_t recip)
+{
+  int32_t x;
+
+  if (t < dt)
+  {
+    /* x = t / dt, residual 2x - x^2 - 1 */
+    x = (int32_t)(((uint64_t)t * recip) >> 32);
+    return (x << 1) - ((x * x) >> 15) - 32768;
+  }
+
+  if ((0U - t) <= dt)
+  {
+    /* x = (1 - t) / dt, residual (1 - x)^2 */
+    x = 32768 - (int32_t)(((uint64_t)(0U - t) * recip) >> 32);
+    return (x * x) >> 15;
+  }
+
+  return 0;
+}
+
+/**
+  * @brief  Accumulate one band-limited saw or square voice
+  * @note   The naive shape is computed from the phase and corrected with a
+  *         two-sample polynomial step at each discontinuity, which removes
+  *         most aliasing without oversampling.
+  * @param  voice   Pointer to voice
+  * @param  mix     Pointer to mono accumulator
+  * @param  frames  Number of frames to render
+  * @retval None
+  */
+static void SYNTH_RenderBlepVoice(SYNTH_Voice_t *voice, int32_t *mix, uint32_t frames)
+{
+  uint32_t phase = voice->Phase;
+  uint32_t inc   = voice->PhaseInc;
+  uint32_t recip = voice->BlepRecip;
+  int32_t  level = voice->Level;
+  int32_t  step  = voice->LevelStep;
+  int32_t  s;
+  uint32_t i;
+
+  if (voice->Waveform == SYNTH_WAVEFORM_SAW_BL)
+  {
+    for (i = 0; i < frames; i++)
+    {
+      s = (int32_t)(phase >> 16) - 32768;
+      s -= SYNTH_PolyBlep(phase, inc, recip);
+      mix[i] = SYNTH_SMLAWB(level >> SYNTH_LEVEL_SHIFT, s, mix[i]);
+      level += step;
+      phase += inc;
+    }
+  }
+  else
+  {
+    for (i = 0; i < frames; i++)
+    {
+      s = (phase & 0x80000000UL) ? -32767 : 32767;
+      s += SYNTH_PolyBlep(phase, inc, recip);
+      s -= SYNTH_PolyBlep(phase + 0x80000000UL, inc, recip);
+
+      /* Both steps overlap near Nyquist, keep the halfword operand valid */
+      mix[i] = SYNTH_SMLAWB(level >> SYNTH_LEVEL_SHIFT, SYNTH_SSAT16(s), mix[i]);
+      level += step;
+      phase += inc;
+    }
+  }
+
+  voice->Phase = phase;
+  voice->Level = level;
+}
+
+#if (SYNTH_MAX_SAMPLERS > 0U)
+/**
+  * @brief  Read one sample frame, from the SRAM copy when it holds it
+  * @param  slot   Pointer to sampler slot
+  * @param  data   Sample data of the slot
+  * @param  frame  Frame index
+  * @retval Q15 sample
+  */
+static inline int32_t SYNTH_SamplerTap(const SYNTH_SamplerSlot_t *slot, const int16_t *data,
+                                       uint32_t frame)
+{
+  uint32_t offset = frame - slot->CacheStart;
+
+  return (offset < slot->CacheFrames) ? slot->Cache[offset] : data[frame];
+}
+
+/**
+  * @brief  Accumulate one sampler voice into the mix buffer
+  * @note   The position advances by a Q16.16 step and the two neighbouring
+  *         frames are interpolated linearly. Past LoopEnd the position wraps
+  *         back into the loop, a one-shot sample frees its voice at the end.
+  * @param  voice   Pointer to voice
+  * @param  mix     Pointer to mono accumulator
+  * @param  frames  Number of frames to render
+  * @retval None
+  */
+static void SYNTH_RenderSampleVoice(SYNTH_Voice_t *voice, int32_t *mix, uint32_t frames)
+{
+  const SYNTH_SamplerSlot_t *slot = voice->Sampler;
+  const SYNTH_Sampler_t     *desc = slot->Desc;
+  const int16_t *data  = desc->Data;
+  uint8_t  loop  = (desc->LoopEnd > desc->LoopStart) ? 1U : 0U;
+  uint32_t end   = loop ? desc->LoopEnd : desc->Length;
+  uint32_t span  = end - desc->LoopStart;
+  uint32_t pos   = voice->SamplePos;
+  uint32_t frac  = voice->Phase;
+  uint32_t inc   = voice->SampleStep;
+  int32_t  level = voice->Level;
+  int32_t  step  = voice->LevelStep;
+  uint32_t next;
+  int32_t  s;
+  int32_t  n;
+  uint32_t i;
+
+  for (i = 0; i < frames; i++)
+  {
+    if (pos >= end)
+    {
+      if (loop == 0U)
+      {
+        voice->Active   = 0;
+        voice->EnvStage = SYNTH_ENV_IDLE;
+        level = 0;
+        break;
+      }
+
+      pos = desc->LoopStart + ((pos - desc->LoopStart) % span);
+    }
+
+    next = pos + 1U;
+    if (next >= end)
+    {
+      next = loop ? desc->LoopStart : pos;
+    }
+
+    s  = SYNTH_SamplerTap(slot, data, pos);
+    n  = SYNTH_SamplerTap(slot, data, next);
+    s += ((n - s) * (int32_t)(frac >> 1)) >> 15;
+
+    mix[i] = SYNTH_SMLAWB(level >> SYNTH_LEVEL_SHIFT, s, mix[i]);
+    level += step;
+
+    frac += inc;
+    pos  += frac >> 16;
+    frac &= 0xFFFFU;
+  }
+
+  voice->SamplePos = pos;
+  voice->Phase     = frac;
+  voice->Level     = level;
+}
+#endif /* SYNTH_MAX_SAMPLERS */
+
+/**
+  * @brief  Dummy transmit function (used if no bus is registered)
+  * @param  pData Pointer to data
+  * @param  size  Data length
+  * @retval Synth status
+  */
+static int32_t SYNTH_DefaultTransmit(uint8_t *pData, uint32_t size)
+{
+  (void)pData;
+  (void)size;
+  return SYNTH_STATUS_ERROR;
+}
+
+/**
+  * @brief  Play a buffer at the software volume through the blocking Transmit
+  * @note   Scaled a stream buffer at a time, the stream is idle meanwhile.
+  * @param  pSynth  Pointer to Synth object
+  * @param  buffer  Interleaved PCM data at the output rate
+  * @param  length  Number of samples in buffer
+  * @retval Synth status
+  */
+static int32_t SYNTH_PlayScaled(SYNTH_Object_t *pSynth, const SYNTH_Sample_t *buffer,
+                                uint32_t length)
+{
+  SYNTH_Sample_t *out  = pSynth->StreamBuffer;
+  int32_t        gain = SYNTH_TargetGain(pSynth);
+  uint32_t count;
+  uint32_t i;
+
+  while (length > 0U)
+  {
+    count = (length > (2U * SYNTH_STREAM_HALF_LENGTH)) ? (2U * SYNTH_STREAM_HALF_LENGTH) : length;
+
+    for (i = 0; i < count; i++)
+    {
+      out[i] = (SYNTH_Sample_t)SYNTH_SatSample(((int64_t)buffer[i] * gain) >> 15);
+    }
+
+    if (pSynth->IO.Transmit((uint8_t *)out, count * sizeof(SYNTH_Sample_t)) != 0)
+    {
+      return SYNTH_STATUS_ERROR;
+    }
+
+    buffer += count;
+    length -= count;
+  }
+
+  return SYNTH_STATUS_OK;
+}
+
+#if (SYNTH_USE_RESAMPLER == 1U)
+/**
+  * @brief  Start playing a buffer through the resampler
+  * @param  pSynth  Pointer to Synth object
+  * @param  buffer  Interleaved source data at Ctx.SourceRate
+  * @param  length  Number of samples in buffer
+  * @retval Synth status
+  */
+static int32_t SYNTH_PlayResampled(SYNTH_Object_t *pSynth, const SYNTH_Sample_t *buffer,
+                                   uint32_t length)
+{
+  int32_t ret;
+
+  pSynth->ResampleSrc    = buffer;
+  pSynth->ResampleFrames = length / SYNTH_CHANNELS;
+  pSynth->ResamplePos    = 0;
+  pSynth->ResampleFrac   = 0;
+  pSynth->ResampleStep   = (uint32_t)(((uint64_t)((pSynth->Ctx.SourceRate != 0U) ?
+                                                  pSynth->Ctx.SourceRate :
+                                                  pSynth->Ctx.SampleRate) << 16) /
+                                      pSynth->Ctx.SampleRate);
+  pSynth->ResampleDrain  = 0;
+  pSynth->Gain           = SYNTH_TargetGain(pSynth);
+
+  ret = SYNTH_StartStream(pSynth, SYNTH_Resample);
+  if (ret == SYNTH_STATUS_OK)
+  {
+    pSynth->Ctx.Transmitting = 1;
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  Stream callback converting PlayBuffer data to the output rate
+  * @note   Once the source is consumed one more half is filled with the
+  *         converter tail, the stream stops when that half has played and
+  *         the SYNTH_TxCallback_t runs as for a direct transfer. The
+  *         software volume is ramped across each half as in SYNTH_Render.
+  * @param  pObj    Pointer to Synth object
+  * @param  buffer  Stream half to fill
+  * @param  length  Number of samples in the half
+  * @retval Synth status
+  */
+static int32_t SYNTH_Resample(void *pObj, SYNTH_Sample_t *buffer, uint32_t length)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)pObj;
+  uint32_t frames = length / SYNTH_CHANNELS;
+  uint32_t pos    = pSynth->ResamplePos;
+  uint32_t frac   = pSynth->ResampleFrac;
+  uint32_t step   = pSynth->ResampleStep;
+  int32_t  target = SYNTH_TargetGain(pSynth);
+  int32_t  gain   = pSynth->Gain << 15;
+  int32_t  ramp   = ((target - pSynth->Gain) << 15) / (int32_t)frames;
+  int32_t  p;
+  uint32_t i;
+  uint32_t ch;
+
+  /* Halves refilled since the source ran out: 1 ends the data, 2 holds
+     the tail and 3 silence. This release is the tail's, it has played */
+  if (pSynth->ResampleDrain >= 3U)
+  {
+    SYNTH_Stop(pSynth);
+
+    if (pSynth->TxCallback)
+    {
+      pSynth->TxCallback(pSynth);
+    }
+    return SYNTH_STATUS_OK;
+  }
+
+  for (i = 0; i < frames; i++)
+  {
+    p = (int32_t)pos;
+
+    for (ch = 0; ch < SYNTH_CHANNELS; ch++)
+    {
+      *buffer++ = (SYNTH_Sample_t)SYNTH_SatSample(
+                    (SYNTH_Cubic(SYNTH_ResampleTap(pSynth, p - 1, ch),
+                                 SYNTH_ResampleTap(pSynth, p, ch),
+                                 SYNTH_ResampleTap(pSynth, p + 1, ch),
+                                 SYNTH_ResampleTap(pSynth, p + 2, ch),
+                                 (int32_t)frac) * (gain >> 15)) >> 15);
+    }
+
+    gain += ramp;
+    frac += step;
+    pos  += frac >> 16;
+    frac &= 0xFFFFU;
+  }
+
+  pSynth->ResamplePos  = pos;
+  pSynth->ResampleFrac = frac;
+  pSynth->Gain         = target;
+
+  if ((pSynth->ResampleDrain != 0U) || (pos >= pSynth->ResampleFrames))
+  {
+    pSynth->ResampleDrain++;
+  }
+
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Read one source sample, zero outside the buffer
+  * @param  pSynth  Pointer to Synth object
+  * @param  frame   Source frame index
+  * @param  ch      Channel
+  * @retval Source sample
+  */
+static inline int32_t SYNTH_ResampleTap(SYNTH_Object_t *pSynth, int32_t frame, uint32_t ch)
+{
+  if ((frame < 0) || ((uint32_t)frame >= pSynth->ResampleFrames))
+  {
+    return 0;
+  }
+
+  return pSynth->ResampleSrc[((uint32_t)frame * SYNTH_CHANNELS) + ch];
+}
+
+/**
+  * @brief  Catmull-Rom cubic interpolation between x1 and x2
+  * @param  x0  Sample before x1
+  * @param  x1  Sample at t = 0
+  * @param  x2  Sample at t = 1
+  * @param  x3  Sample after x2
+  * @param  t   Q16 position between x1 and x2
+  * @retval Interpolated sample, may overshoot the sample range
+  */
+static inline int64_t SYNTH_Cubic(int32_t x0, int32_t x1, int32_t x2, int32_t x3, int32_t t)
+{
+  /* Coefficients at twice their value, halved once at the end */
+  int64_t a = (3 * ((int64_t)x1 - x2)) + x3 - x0;
+  int64_t b = (2 * (int64_t)x0) - (5 * (int64_t)x1) + (4 * (int64_t)x2) - x3;
+  int64_t c = (int64_t)x2 - x0;
+  int64_t y;
+
+  y = (a * t) >> 16;
+  y = ((y + b) * t) >> 16;
+  y = ((y + c) * t) >> 16;
+
+  return x1 + (y >> 1);
+}
+#endif /* SYNTH_USE_RESAMPLER */
+
+/**
+  * @brief  Software output gain implied by volume and mute
+  * @note   Unity when the codec implements the corresponding control.
+  * @param  pSynth  Pointer to Synth object
+  * @retval Q15 gain
+  */
+static int32_t SYNTH_TargetGain(SYNTH_Object_t *pSynth)
+{
+  if (pSynth->PendingSampleRate != 0U)
+  {
+    return 0;
+  }
+
+  if (pSynth->Ctx.Mute && (pSynth->IO.Mute == NULL))
+  {
+    return 0;
+  }
+
+  if (pSynth->IO.SetVolume)
+  {
+    return 32767;
+  }
+
+  return SynthVolumeTable[pSynth->Ctx.Volume];
+}
+
+/**
+  * @brief  Refill one stream half-buffer
+  * @note   Without a callback the half is only marked free for
+  *         SYNTH_AcquireBuffer, keeping its previous contents.
+  * @param  pSynth  Pointer to Synth object
+  * @param  index   Half released by the DMA, 0 or 1
+  * @retval None
+  */
+static void SYNTH_StreamRefill(SYNTH_Object_t *pSynth, uint32_t index)
+{
+  uint32_t length = SYNTH_STREAM_HALF_LENGTH;
+  SYNTH_Sample_t *buffer = &pSynth->StreamBuffer[index * length];
+  uint32_t other;
+#if (SYNTH_USE_STATS == 1U)
+  uint32_t start = SYNTH_CYCLE_COUNT();
+  uint32_t cycles;
+#endif
+
+  if (pSynth->StreamCallback)
+  {
+    /* SYNTH_Render sets the silent bit again if it leaves zeros behind */
+    if (pSynth->StreamCallback != SYNTH_Render)
+    {
+      SYNTH_BITS_CLEAR(pSynth->StreamSilent, 1U << index);
+    }
+
+    pSynth->StreamCallback(pSynth, buffer, length);
+    SYNTH_DCACHE_CLEAN(buffer, length * sizeof(SYNTH_Sample_t));
+  }
+  else if (pSynth->Ctx.Streaming)
+  {
+    other = index ^ 1U;
+
+    /* The other half starts playing now. Without a commit since its
+       release it still holds stale samples: write the substitute ahead of
+       the DMA, unless the application is writing it right now */
+    if (pSynth->StreamFree & (1U << other))
+    {
+      pSynth->StreamUnderruns++;
+      pSynth->StreamMissed = 1;
+      SYNTH_BITS_SET(pSynth->StreamLate, 1U << other);
+
+      if ((pSynth->StreamAcquired == 0U) || (pSynth->StreamNext != other))
+      {
+        SYNTH_StreamSubstitute(pSynth, other);
+      }
+    }
+
+    SYNTH_BITS_CLEAR(pSynth->StreamLate, 1U << index);
+    SYNTH_BITS_SET(pSynth->StreamFree, 1U << index);
+  }
+  else
+  {
+    /* Priming before the DMA starts */
+    memset(buffer, 0, length * sizeof(SYNTH_Sample_t));
+    SYNTH_BITS_SET(pSynth->StreamSilent, 1U << index);
+    SYNTH_DCACHE_CLEAN(buffer, length * sizeof(SYNTH_Sample_t));
+  }
+
+#if (SYNTH_USE_STATS == 1U)
+  cycles = SYNTH_CYCLE_COUNT() - start;
+
+  SYNTH_StatsRecord(&pSynth->Stats.IsrCycles, &pSynth->Stats.IsrCyclesMax, cycles);
+  pSynth->Stats.IsrCyclesAvg += (uint32_t)((int32_t)(cycles - pSynth->Stats.IsrCyclesAvg) >> 4);
+#endif
+}
+
+#if (SYNTH_USE_RTOS == 1U)
+/**
+  * @brief  Wake the render task for a released stream half
+  * @note   Runs in the DMA interrupt. Only pull mode streams are rendered
+  *         by the task, a refill callback already ran in the ISR.
+  * @param  pSynth  Pointer to Synth object
+  * @retval None
+  */
+static void SYNTH_RenderTaskNotify(SYNTH_Object_t *pSynth)
+{
+  if (pSynth->StreamCallback == NULL)
+  {
+#if (SYNTH_USE_STATS == 1U)
+    pSynth->Rtos.Released = SYNTH_CYCLE_COUNT();
+#endif
+    SYNTH_RtosNotifyFromISR(&pSynth->Rtos);
+  }
+}
+
+/**
+  * @brief  Render task body
+  * @note   Commands land between halves, never inside a render pass, and
+  *         at most one queue length of them per wake so a flood of
+  *         requests cannot push the render past its deadline.
+  * @param  arg  Pointer to Synth object
+  * @retval None
+  */
+static void SYNTH_RenderTask(void *arg)
+{
+  SYNTH_Object_t *pSynth = (SYNTH_Object_t *)arg;
+  SYNTH_Command_t command;
+  SYNTH_Sample_t *buffer;
+  uint32_t length;
+  uint32_t count;
+  int32_t  status;
+#if (SYNTH_USE_STATS == 1U)
+  uint32_t woke;
+  uint8_t  first;
+#endif
+
+  for (;;)
+  {
+    SYNTH_RtosWait(&pSynth->Rtos);
+#if (SYNTH_USE_STATS == 1U)
+    woke  = SYNTH_CYCLE_COUNT();
+    first = 1;
+#endif
+
+    for (count = 0; count < SYNTH_RTOS_QUEUE_LENGTH; count++)
+    {
+      if (SYNTH_RtosReceive(&pSynth->Rtos, &command) != SYNTH_STATUS_OK)
+      {
+        break;
+      }
+      SYNTH_ApplyCommand(pSynth, &command);
+    }
+
+    /* A missed half is already counted as an underrun by the ISR */
+    status = SYNTH_AcquireBuffer(pSynth, &buffer, &length);
+    while ((status == SYNTH_STATUS_OK) || (status == SYNTH_STATUS_TIMEOUT))
+    {
+#if (SYNTH_USE_STATS == 1U)
+      if (first)
+      {
+        SYNTH_StatsRecord(&pSynth->Stats.WakeCycles, &pSynth->Stats.WakeCyclesMax,
+                          woke - pSynth->Rtos.Released);
+        first = 0;
+      }
+#endif
+      (void)SYNTH_Render(pSynth, buffer, length);
+
+      if (SYNTH_CommitBuffer(pSynth) == SYNTH_STATUS_TIMEOUT)
+      {
+        SYNTH_STATS_INC(pSynth, DeadlineMisses);
+      }
+
+      status = SYNTH_AcquireBuffer(pSynth, &buffer, &length);
+    }
+  }
+}
+
+/**
+  * @brief  Execute one queued command in the render task
+  * @param  pSynth   Pointer to Synth object
+  * @param  command  Pointer to command
+  * @retval None
+  */
+static void SYNTH_ApplyCommand(SYNTH_Object_t *pSynth, const SYNTH_Command_t *command)
+{
+  switch (command->Type)
+  {
+    case SYNTH_CMD_NOTE_ON:
+      (void)SYNTH_NoteOn(pSynth, command->Note, command->Value);
+      break;
+    case SYNTH_CMD_NOTE_OFF:
+      (void)SYNTH_NoteOff(pSynth, command->Note);
+      break;
+    case SYNTH_CMD_VOLUME:
+      (void)SYNTH_SetVolume(pSynth, command->Value);
+      break;
+    case SYNTH_CMD_MUTE:
+      (void)SYNTH_Mute(pSynth, command->Value);
+      break;
+    case SYNTH_CMD_WAVEFORM:
+      (void)SYNTH_SetWaveform(pSynth, command->Value);
+      break;
+    case SYNTH_CMD_PLAY_BUFFER:
+      (void)SYNTH_QueueBuffer(pSynth, (const SYNTH_Sample_t *)command->Data, command->Length,
+                              command->Value, NULL);
+      break;
+    case SYNTH_CMD_PRESET:
+      (void)SYNTH_LoadPreset(pSynth, command->Data, command->Length);
+      break;
+    case SYNTH_CMD_START:
+      (void)SYNTH_StartStream(pSynth, NULL);
+      break;
+    case SYNTH_CMD_STOP:
+      (void)SYNTH_Stop(pSynth);
+      break;
+    default:
+      break;
+  }
+}
+#endif /* SYNTH_USE_RTOS */
+
+/**
+  * @brief  Write the underrun substitute into a stream half
+  * @note   Runs only when a pull mode half starts playing uncommitted, so
+  *         the DMA does not replay stale samples. It is written from the
+  *         release interrupt, ahead of the DMA read pointer, which has at
+  *         most fetched its first frames. The fade copies the half that
+  *         just played with a linear ramp to zero, repeated misses decay.
+  * @param  pSynth  Pointer to Synth object
+  * @param  index   Half starting to play, 0 or 1
+  * @retval None
+  */
+static void SYNTH_StreamSubstitute(SYNTH_Object_t *pSynth, uint32_t index)
+{
+  SYNTH_Sample_t *dst = &pSynth->StreamBuffer[index * SYNTH_STREAM_HALF_LENGTH];
+
+#if (SYNTH_UNDERRUN_FILL == SYNTH_UNDERRUN_FADE)
+  const SYNTH_Sample_t *src = &pSynth->StreamBuffer[(index ^ 1U) * SYNTH_STREAM_HALF_LENGTH];
+  int32_t  gain = 32767;
+  int32_t  step = 32767 / (int32_t)SYNTH_STREAM_BLOCK_SIZE;
+  uint32_t i;
+  uint32_t ch;
+
+  for (i = 0; i < SYNTH_STREAM_BLOCK_SIZE; i++)
+  {
+    for (ch = 0; ch < SYNTH_CHANNELS; ch++)
+    {
+      *dst++ = (SYNTH_Sample_t)(((int64_t)*src++ * gain) >> 15);
+    }
+    gain -= step;
+  }
+
+  SYNTH_BITS_CLEAR(pSynth->StreamSilent, 1U << index);
+  dst -= SYNTH_STREAM_HALF_LENGTH;
+#else
+  if ((pSynth->StreamSilent & (1U << index)) == 0U)
+  {
+    memset(dst, 0, SYNTH_STREAM_HALF_LENGTH * sizeof(SYNTH_Sample_t));
+    SYNTH_BITS_SET(pSynth->StreamSilent, 1U << index);
+  }
+#endif
+
+  SYNTH_DCACHE_CLEAN(dst, SYNTH_STREAM_HALF_LENGTH * sizeof(SYNTH_Sample_t));
+}
+
+#if (SYNTH_USE_STATS == 1U)
+/**
+  * @brief  Store a cycle measurement and track its peak
+  * @param  last    Pointer to the last value
+  * @param  max     Pointer to the peak value
+  * @param  cycles  Measured cycles
+  * @retval None
+  */
+static void SYNTH_StatsRecord(uint32_t *last, uint32_t *max, uint32_t cycles)
+{
+  *last = cycles;
+
+  if (cycles > *max)
+  {
+    *max = cycles;
+  }
 }
+#endif
 
 /**
   * @}
@@ -27,6 +27,10 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include <stdint.h>
+#include "synth_conf.h"
+#include "synth_pool.h"
+#include "synth_fx.h"
+#include "synth_rtos.h"
 
 /** @addtogroup BSP
   * @{
@@ -51,9 +55,94 @@
 
 /* Default audio configuration values */
 #define SYNTH_DEFAULT_SAMPLE_RATE   44100U   /*!< Default sample rate in Hz */
-#define SYNTH_DEFAULT_CHANNELS      2U       /*!< Stereo output by default  */
+#define SYNTH_DEFAULT_CHANNELS      SYNTH_CHANNELS
 #define SYNTH_DEFAULT_VOLUME        75U      /*!< Volume (0-100 scale)      */
 
+/* Samples per DMA half-buffer */
+#define SYNTH_STREAM_HALF_LENGTH    (SYNTH_STREAM_BLOCK_SIZE * SYNTH_CHANNELS)
+
+/* Stream underrun substitutes for SYNTH_UNDERRUN_FILL */
+#define SYNTH_UNDERRUN_SILENCE      0U       /*!< Missed halves play zeros          */
+#define SYNTH_UNDERRUN_FADE         1U       /*!< Repeat the last half fading out   */
+
+/* USB feedback endpoint formats for SYNTH_USB_FEEDBACK_FORMAT */
+#define SYNTH_USB_FEEDBACK_10_14    0U       /*!< Full speed, frames per 1 ms frame     */
+#define SYNTH_USB_FEEDBACK_16_16    1U       /*!< High speed, frames per 125 us microframe */
+
+/* Voice stealing policies for SYNTH_VOICE_STEAL_POLICY */
+#define SYNTH_STEAL_OLDEST          0U       /*!< Steal the longest playing voice */
+#define SYNTH_STEAL_QUIETEST        1U       /*!< Steal the lowest gain voice     */
+
+/* Configuration checks, see synth_conf_template.h */
+#if (SYNTH_CHANNELS != 1U) && (SYNTH_CHANNELS != 2U)
+#error "SYNTH_CHANNELS must be 1 or 2"
+#endif
+
+#if (SYNTH_SAMPLE_BITS != 16U) && (SYNTH_SAMPLE_BITS != 24U) && (SYNTH_SAMPLE_BITS != 32U)
+#error "SYNTH_SAMPLE_BITS must be 16, 24 or 32"
+#endif
+
+#if ((SYNTH_EVENT_QUEUE_SIZE & (SYNTH_EVENT_QUEUE_SIZE - 1U)) != 0U)
+#error "SYNTH_EVENT_QUEUE_SIZE must be a power of two"
+#endif
+
+#if (SYNTH_USE_USB_INPUT == 1U) && \
+    ((SYNTH_USB_RING_FRAMES & (SYNTH_USB_RING_FRAMES - 1U)) != 0U)
+#error "SYNTH_USB_RING_FRAMES must be a power of two"
+#endif
+
+#if (SYNTH_USE_USB_INPUT == 1U) && (SYNTH_MAX_CLIPS == 0U)
+#error "SYNTH_USE_USB_INPUT mixes on the clip bus, SYNTH_MAX_CLIPS must be > 0"
+#endif
+
+/* Envelope defaults */
+#define SYNTH_DEFAULT_ATTACK_MS     5U       /*!< Linear rise to peak        */
+#define SYNTH_DEFAULT_DECAY_MS      100U     /*!< 60 dB exponential fall     */
+#define SYNTH_DEFAULT_SUSTAIN       80U      /*!< Percent of peak            */
+#define SYNTH_DEFAULT_RELEASE_MS    200U     /*!< 60 dB exponential fall     */
+
+/* Envelope stages */
+#define SYNTH_ENV_IDLE              0x00U
+#define SYNTH_ENV_ATTACK            0x01U
+#define SYNTH_ENV_DECAY             0x02U
+#define SYNTH_ENV_SUSTAIN           0x03U
+#define SYNTH_ENV_RELEASE           0x04U
+
+/* Event types */
+#define SYNTH_EVENT_NOTE_ON         0x00U
+#define SYNTH_EVENT_NOTE_OFF        0x01U
+#define SYNTH_EVENT_FREQUENCY       0x02U
+
+/* Filter stages for SYNTH_SetFilter */
+#define SYNTH_FILTER_VOICE          0x00U    /*!< Every voice, cutoff follows the note */
+#define SYNTH_FILTER_MASTER         0x01U    /*!< Summed output before the gain stage */
+
+/* Modulation targets for SYNTH_ModRoute_t */
+#define SYNTH_MOD_NONE              0x00U
+#define SYNTH_MOD_PITCH             0x01U    /*!< Depth in cents, -2400 to 2400 */
+#define SYNTH_MOD_AMP               0x02U    /*!< Depth in percent, -100 to 100 */
+#define SYNTH_MOD_CUTOFF            0x03U    /*!< Depth in semitones            */
+#define SYNTH_MOD_PITCH_RANGE       2400     /*!< SYNTH_MOD_PITCH depth limit    */
+
+/* Preset image header, see SYNTH_Preset_t */
+#define SYNTH_PRESET_MAGIC          0x50594E53UL /*!< "SNYP" read as little-endian */
+#define SYNTH_PRESET_VERSION        1U
+
+/* Wavetable oscillator configuration */
+#define SYNTH_WAVETABLE_BITS        8U       /*!< log2 of samples per table */
+#define SYNTH_WAVETABLE_SIZE        (1UL << SYNTH_WAVETABLE_BITS)
+
+/* Waveform identifiers */
+#define SYNTH_WAVEFORM_SINE         0x00U
+#define SYNTH_WAVEFORM_SQUARE       0x01U
+#define SYNTH_WAVEFORM_SAW          0x02U
+#define SYNTH_WAVEFORM_TRIANGLE     0x03U
+#define SYNTH_WAVEFORM_SAW_BL       0x04U    /*!< PolyBLEP band-limited saw    */
+#define SYNTH_WAVEFORM_SQUARE_BL    0x05U    /*!< PolyBLEP band-limited square */
+#define SYNTH_WAVEFORM_USER         0x06U    /*!< First user table slot     */
+#define SYNTH_WAVEFORM_SAMPLER      (SYNTH_WAVEFORM_USER + SYNTH_MAX_USER_WAVETABLES)
+#define SYNTH_WAVEFORM_COUNT        (SYNTH_WAVEFORM_SAMPLER + SYNTH_MAX_SAMPLERS)
+
 /**
   * @}
   */
@@ -62,6 +151,17 @@
   * @{
   */
 
+/**
+  * @brief  Output sample container
+  * @note   24-bit samples are right-justified and sign-extended in 32 bits,
+  *         the layout expected by SAI/I2S DMA with a 24-bit data size.
+  */
+#if (SYNTH_SAMPLE_BITS == 16U)
+typedef int16_t SYNTH_Sample_t;
+#else
+typedef int32_t SYNTH_Sample_t;
+#endif
+
 /**
   * @brief  Synth driver function structure
   */
@@ -75,7 +175,7 @@ typedef struct
   int32_t (*GetSampleRate)     (void*, uint32_t *sample_rate);
 
   /* Audio playback */
-  int32_t (*PlayBuffer)        (void*, const int16_t *buffer, uint32_t length);
+  int32_t (*PlayBuffer)        (void*, const SYNTH_Sample_t *buffer, uint32_t length);
   int32_t (*Stop)              (void*);
   int32_t (*Pause)             (void*);
   int32_t (*Resume)            (void*);
@@ -93,6 +193,21 @@ typedef struct
 
 } SYNTH_Drv_t;
 
+/**
+  * @brief  Synth stream refill callback
+  *         Called from the DMA half/complete interrupt with the half-buffer
+  *         that has just been released; length is in samples. SYNTH_Render
+  *         matches this signature to render the voice engine directly.
+  */
+typedef int32_t (*SYNTH_StreamCallback_t)(void *pObj, SYNTH_Sample_t *buffer, uint32_t length);
+
+/**
+  * @brief  Synth transfer complete callback
+  *         Called from the DMA complete interrupt once an asynchronous
+  *         PlayBuffer transfer has finished and its buffer can be reused.
+  */
+typedef void (*SYNTH_TxCallback_t)(void *pObj);
+
 /**
   * @brief  Synth I/O function structure
   *         (hardware abstraction for audio interface)
@@ -102,11 +217,197 @@ typedef struct
   int32_t (*Init)              (void);
   int32_t (*DeInit)            (void);
   int32_t (*Transmit)          (uint8_t *pData, uint32_t size);
-  int32_t (*SetSampleRate)     (uint32_t sample_rate);
+  int32_t (*SetSampleRate)     (uint32_t sample_rate); /*!< May run from the DMA ISR */
   int32_t (*GetSampleRate)     (uint32_t *sample_rate);
   int32_t (*Mute)              (uint8_t enable);
+  int32_t (*SetVolume)         (uint8_t volume);   /*!< Codec gain, optional */
+
+  /* Non-blocking DMA transfers, optional. Completion is reported by
+     calling SYNTH_TxHalfCpltCallback / SYNTH_TxCpltCallback. */
+  int32_t (*TransmitAsync)     (uint8_t *pData, uint32_t size);
+  int32_t (*TransmitCircular)  (uint8_t *pData, uint32_t size);
+  int32_t (*TransmitStop)      (void);
+  int32_t (*Pause)             (void);
+  int32_t (*Resume)            (void);
 } SYNTH_IO_t;
 
+/**
+  * @brief  Synth sampler descriptor
+  * @note   Referenced, not copied, like the sample data it points to, so
+  *         both may live in internal flash or XIP-mapped QSPI/OCTOSPI.
+  */
+typedef struct
+{
+  const int16_t *Data;   /*!< Mono Q15 samples                            */
+  uint32_t Length;       /*!< Frames in Data                              */
+  uint32_t LoopStart;    /*!< First frame of the sustain loop             */
+  uint32_t LoopEnd;      /*!< Frame after the loop, LoopStart to play once */
+  uint32_t SampleRate;   /*!< Recording rate in Hz                        */
+  uint8_t  RootNote;     /*!< MIDI note played at the recorded pitch      */
+} SYNTH_Sampler_t;
+
+/**
+  * @brief  Synth sampler slot, see SYNTH_LoadSampler
+  */
+typedef struct
+{
+  const SYNTH_Sampler_t *Desc;
+  const int16_t *Cache;  /*!< SRAM copy of the hot region, from the pool  */
+  uint32_t CacheStart;   /*!< First frame held in Cache                   */
+  uint32_t CacheFrames;  /*!< Frames held in Cache, 0 reads Data only     */
+  uint32_t Scale;        /*!< Q16 frames per period at the root pitch     */
+} SYNTH_SamplerSlot_t;
+
+/**
+  * @brief  Synth voice structure
+  */
+typedef struct
+{
+  uint32_t Phase;        /*!< Phase accumulator, full scale is one period */
+  uint32_t PhaseInc;     /*!< Phase increment per sample                  */
+  uint32_t BaseInc;      /*!< PhaseInc before pitch modulation            */
+  uint32_t BlepRecip;    /*!< 2^47 / PhaseInc, for band-limited waveforms */
+  uint32_t Age;          /*!< Allocation stamp, lower is older            */
+  const int16_t *Table;  /*!< Wavetable of SYNTH_WAVETABLE_SIZE samples   */
+  int32_t  Level;        /*!< Q30 envelope amplitude, velocity included   */
+  int32_t  LevelStep;    /*!< Level change per sample for this block      */
+  int32_t  Peak;         /*!< Q30 attack target from velocity             */
+  uint8_t  EnvStage;     /*!< SYNTH_ENV_xxx                               */
+  uint8_t  Note;
+  uint8_t  Waveform;
+  uint8_t  Active;
+  uint8_t  Dirty;        /*!< Derived state to refresh before rendering   */
+#if (SYNTH_USE_FILTER == 1U)
+  int32_t  FilterCoeffs[5]; /*!< Q30 b0, b1, b2, a1, a2, CMSIS DF1 layout  */
+  int32_t  FilterState[4];
+#endif
+#if (SYNTH_MAX_SAMPLERS > 0U)
+  const SYNTH_SamplerSlot_t *Sampler; /*!< NULL for oscillator voices    */
+  uint32_t SamplePos;    /*!< Current frame, Phase holds the Q16 fraction */
+  uint32_t SampleStep;   /*!< Q16.16 frames per output sample            */
+#endif
+} SYNTH_Voice_t;
+
+/**
+  * @brief  Synth envelope structure
+  */
+typedef struct
+{
+  uint16_t Attack;       /*!< Attack time in ms                           */
+  uint16_t Decay;        /*!< Decay time to -60 dB in ms                  */
+  uint16_t Release;      /*!< Release time to -60 dB in ms                */
+  uint8_t  Sustain;      /*!< Sustain level, percent of peak (0-100)      */
+} SYNTH_Envelope_t;
+
+/**
+  * @brief  Synth PCM clip mixed with the voices
+  * @note   The samples are referenced, interleaved like the output.
+  */
+typedef struct
+{
+  const SYNTH_Sample_t *Data;
+  uint32_t Frames;
+  uint32_t Pos;          /*!< Next frame to mix                           */
+  int32_t  Gain;         /*!< Q15 from the 0-100 volume curve             */
+  volatile uint8_t Active;
+} SYNTH_Clip_t;
+
+/**
+  * @brief  Synth low-pass filter structure
+  */
+typedef struct
+{
+  uint8_t  Enable;
+  int8_t   Cutoff;       /*!< Voice: semitones from the note, master: MIDI note */
+  uint8_t  Resonance;    /*!< 0 (Q 0.707) to 100 (Q 10)                   */
+} SYNTH_Filter_t;
+
+/**
+  * @brief  Synth low-frequency oscillator structure
+  */
+typedef struct
+{
+  uint8_t  Shape;        /*!< SYNTH_WAVEFORM_xxx wavetable                */
+  uint16_t Rate;         /*!< Frequency in 0.01 Hz                        */
+} SYNTH_Lfo_t;
+
+/**
+  * @brief  Synth modulation matrix entry
+  */
+typedef struct
+{
+  uint8_t  Source;       /*!< LFO index                                   */
+  uint8_t  Target;       /*!< SYNTH_MOD_xxx                               */
+  int16_t  Depth;        /*!< Full-scale LFO amount, unit per target      */
+} SYNTH_ModRoute_t;
+
+/**
+  * @brief  Synth preset image, 32 bytes little-endian
+  * @note   Stored exactly as laid out here so a file read from storage is
+  *         handed to SYNTH_LoadPreset as is. A later version only appends
+  *         fields and raises Version and Size.
+  */
+typedef struct
+{
+  uint32_t Magic;        /*!< SYNTH_PRESET_MAGIC                          */
+  uint16_t Version;      /*!< SYNTH_PRESET_VERSION                        */
+  uint16_t Size;         /*!< sizeof(SYNTH_Preset_t)                      */
+  SYNTH_Envelope_t Envelope;     /*!< Offset 8, one padding byte          */
+  SYNTH_Filter_t   VoiceFilter;  /*!< Offset 16                           */
+  SYNTH_Filter_t   MasterFilter; /*!< Offset 19                           */
+  uint8_t  Waveform;     /*!< SYNTH_WAVEFORM_xxx for new notes            */
+  uint8_t  Reserved[9];  /*!< Zero                                        */
+} SYNTH_Preset_t;
+
+/**
+  * @brief  Synth event structure
+  *         Queued by the control context, applied by the render stage
+  */
+typedef struct
+{
+  uint32_t Time;         /*!< Sample clock at which the event applies     */
+  float    Frequency;    /*!< SYNTH_EVENT_FREQUENCY target in Hz          */
+  uint8_t  Type;         /*!< SYNTH_EVENT_xxx                             */
+  uint8_t  Note;
+  uint8_t  Velocity;
+  uint8_t  Waveform;     /*!< Waveform selected when the note was posted  */
+} SYNTH_Event_t;
+
+/**
+  * @brief  Synth profiling counters, see SYNTH_USE_STATS
+  * @note   Cycle figures are DWT CYCCNT deltas for one render block of
+  *         at most SYNTH_STREAM_BLOCK_SIZE frames or one DMA refill.
+  */
+typedef struct
+{
+  uint32_t RenderCycles;    /*!< Last block, events to output samples   */
+  uint32_t RenderCyclesMax;
+  uint32_t MixCycles;       /*!< Last block, voice rendering and mixing */
+  uint32_t MixCyclesMax;
+  uint32_t IsrCycles;       /*!< Last half-buffer refill                */
+  uint32_t IsrCyclesMax;
+  uint32_t IsrCyclesAvg;    /*!< Running average, 1/16 weight           */
+  uint32_t Underruns;       /*!< Half-buffers the application missed   */
+  uint32_t VoiceSteals;     /*!< Notes that took over a sounding voice */
+  uint32_t SecondaryLate;   /*!< Blocks without the second core sub-mix */
+  uint32_t WakeCycles;      /*!< Last DMA release to render task wake   */
+  uint32_t WakeCyclesMax;
+  uint32_t DeadlineMisses;  /*!< Render task halves committed too late  */
+  uint32_t UsbOverruns;     /*!< USB packets refused, input ring full   */
+  uint32_t UsbUnderruns;    /*!< Blocks the USB input ring ran dry      */
+} SYNTH_Stats_t;
+
+/**
+  * @brief  Synth render stage benchmark result, see SYNTH_Benchmark
+  */
+typedef struct
+{
+  uint32_t Frames;            /*!< Frames pushed through each stage          */
+  uint64_t EnvelopeCycles;    /*!< Block-rate envelope updates               */
+  uint64_t OscillatorCycles;  /*!< Oscillators accumulated into the mix bus  */
+  uint64_t OutputCycles;      /*!< Gain ramp, saturation and sample packing  */
+} SYNTH_Bench_t;
+
 /**
   * @brief  Synth context structure
   *         Used to keep runtime configuration
@@ -114,12 +415,181 @@ typedef struct
 typedef struct
 {
   uint32_t SampleRate;
+  uint32_t SourceRate;   /*!< PlayBuffer data rate, 0 for the output rate */
   uint8_t  Channels;
   uint8_t  Volume;
   uint8_t  Mute;
   uint8_t  Initialized;
+  uint8_t  Streaming;
+  uint8_t  Transmitting;
+  uint8_t  Paused;
+  uint8_t  Waveform;
 } SYNTH_Ctx_t;
 
+/**
+  * @brief  Synth object structure
+  *         One instance per audio output, passed as pObj to every function
+  */
+typedef struct
+{
+  SYNTH_IO_t             IO;
+  SYNTH_Ctx_t            Ctx;
+
+  /* Voice engine */
+  SYNTH_Voice_t          Voices[SYNTH_MAX_VOICES];
+  SYNTH_Voice_t          *LastVoice;
+  uint32_t               VoiceAge;
+  const int16_t          *Wavetables[SYNTH_WAVEFORM_COUNT];
+#if (SYNTH_MAX_SAMPLERS > 0U)
+  SYNTH_SamplerSlot_t    Samplers[SYNTH_MAX_SAMPLERS];
+#endif
+
+  /* Event queue, single producer / single consumer, free-running indexes */
+  SYNTH_Event_t          Events[SYNTH_EVENT_QUEUE_SIZE];
+  volatile uint32_t      EventHead;
+  volatile uint32_t      EventTail;
+  volatile uint32_t      SampleClock;   /*!< Frames rendered since Init */
+
+  /* Envelope settings and the per-block coefficients derived from them */
+  SYNTH_Envelope_t       Envelope;
+  int32_t                EnvAttackInc;  /*!< Q30 fraction of peak per block */
+  int32_t                EnvDecayCoef;  /*!< Q30 multiplier per block       */
+  int32_t                EnvReleaseCoef;
+  int32_t                EnvDecayStep;  /*!< Q30 multiplier per sample      */
+  int32_t                EnvReleaseStep;
+  int32_t                EnvSustain;    /*!< Q15 fraction of peak           */
+
+  /* Phase increments for MIDI octave 4 and per Hz, refreshed on rate change */
+  uint32_t               NoteInc[12];
+  float                  PhaseIncPerHz;
+  volatile uint32_t      PendingSampleRate; /*!< Deferred while streaming, 0 if none */
+
+#if (SYNTH_MAX_LFOS > 0U)
+  /* LFOs and the modulation matrix, evaluated once per render block */
+  SYNTH_Lfo_t            Lfos[SYNTH_MAX_LFOS];
+  uint32_t               LfoPhase[SYNTH_MAX_LFOS];
+  uint32_t               LfoInc[SYNTH_MAX_LFOS]; /*!< Per frame at the current rate */
+  SYNTH_ModRoute_t       ModRoutes[SYNTH_MOD_SLOTS];
+  uint32_t               PitchRatio;    /*!< Q30 increment multiplier       */
+  int32_t                ModGain;       /*!< Q15 master gain ramp end point */
+  int32_t                ModCutoff;     /*!< Semitones added to cutoffs     */
+#endif
+
+  /* Preset waiting for the next block boundary, see SYNTH_LoadPreset */
+  SYNTH_Preset_t         Preset;
+  volatile uint8_t       PresetPending;
+
+#if (SYNTH_USE_FILTER == 1U)
+  /* Filters, coefficients come from the per-note table at block rate */
+  SYNTH_Filter_t         VoiceFilter;
+  SYNTH_Filter_t         MasterFilter;
+  int32_t                VoiceFilterDamp;   /*!< Q16 1/(2Q) */
+  int32_t                MasterFilterDamp;
+  int32_t                MasterCoeffs[5];
+  int32_t                MasterState[4];
+  int32_t                FilterCos[128];    /*!< Q30 cos(w0) per MIDI note */
+  int32_t                FilterSin[128];    /*!< Q30 sin(w0) per MIDI note */
+  int32_t                VoiceBuffer[SYNTH_STREAM_BLOCK_SIZE];
+#endif
+
+  /* Derived state waiting for the next block boundary */
+  volatile uint8_t       Dirty;
+
+  /* Output stage: current Q15 gain and mono mix accumulator for one block */
+  int32_t                Gain;
+  int32_t                GainTarget;    /*!< Q15 gain implied by volume and mute */
+  int32_t                MixBuffer[SYNTH_STREAM_BLOCK_SIZE];
+
+#if (SYNTH_MAX_CLIPS > 0U)
+  /* PCM clips summed after the voices, on a stereo bus of their own when
+     the output is stereo */
+  SYNTH_Clip_t           Clips[SYNTH_MAX_CLIPS];
+  uint8_t                ClipsMixed;    /*!< ClipBuffer holds this block */
+#if (SYNTH_CHANNELS == 2U)
+  int32_t                ClipBuffer[SYNTH_STREAM_HALF_LENGTH];
+#endif
+#endif
+
+#if (SYNTH_USE_USB_INPUT == 1U)
+  /* USB Audio input ring, the OUT endpoint receives in place. Positions
+     are the free running counters masked, a packet crossing the end runs
+     on into the spare frames and is folded back to the bottom. */
+  SYNTH_Sample_t         UsbRing[(SYNTH_USB_RING_FRAMES + SYNTH_USB_PACKET_FRAMES) *
+                                 SYNTH_CHANNELS] SYNTH_DMA_ALIGN;
+  volatile uint32_t      UsbHead;       /*!< Frames received, free running */
+  volatile uint32_t      UsbTail;       /*!< Frames mixed, free running    */
+  uint32_t               UsbFill;       /*!< Q8 averaged fill in frames    */
+  int32_t                UsbGain;       /*!< Q15                           */
+  uint8_t                UsbPrimed;     /*!< Fill reached half the ring    */
+  volatile uint8_t       UsbActive;
+#endif
+
+  /* Asynchronous PlayBuffer completion */
+  SYNTH_TxCallback_t     TxCallback;
+
+  /* Fixed-block pool over application memory, see SYNTH_RegisterPool */
+  SYNTH_Pool_t           Pool;
+
+#if (SYNTH_USE_DUAL_CORE == 1U)
+  /* Odd voice slots render on the second core, see SYNTH_RenderSecondary */
+  int32_t                SubMix[SYNTH_STREAM_BLOCK_SIZE];
+#if (SYNTH_USE_FILTER == 1U)
+  int32_t                SubVoiceBuffer[SYNTH_STREAM_BLOCK_SIZE];
+#endif
+  volatile uint32_t      SubFrames;
+  volatile uint32_t      SubRequest;    /*!< Block sequence posted by the first core */
+  volatile uint32_t      SubDone;       /*!< Block sequence finished by the second   */
+  volatile uint8_t       SubDirty;      /*!< Voice dirty bits for the odd slots      */
+  uint8_t                SubHeld;       /*!< Bits raised while the second core lagged */
+  uint8_t                SubMissed;     /*!< A block went out without the sub-mix    */
+#endif
+
+#if SYNTH_USE_FX
+  /* Master effects, delay lines come from the bulk pool */
+  SYNTH_Pool_t           BulkPool;
+  SYNTH_Fx_t             Fx;
+#endif
+
+#if (SYNTH_USE_RTOS == 1U)
+  /* Render task fed by the DMA interrupt, see SYNTH_StartRenderTask */
+  SYNTH_Rtos_t           Rtos;
+#endif
+
+#if (SYNTH_USE_STATS == 1U)
+  SYNTH_Stats_t          Stats;
+#endif
+
+  /* PlayBuffer sample rate conversion through the stream buffer */
+  const SYNTH_Sample_t   *ResampleSrc;
+  uint32_t               ResampleFrames; /*!< Source length in frames      */
+  uint32_t               ResamplePos;    /*!< Integer source frame         */
+  uint32_t               ResampleFrac;   /*!< Q16 fraction between frames  */
+  uint32_t               ResampleStep;   /*!< Q16.16 source frames per output frame */
+  uint8_t                ResampleDrain;  /*!< Halves refilled after the end */
+
+  /* Ping-pong stream buffer: two contiguous halves read by one circular DMA.
+     The object must be placed in DMA-reachable SRAM (not DTCM/CCM). */
+  SYNTH_StreamCallback_t StreamCallback;
+  volatile uint8_t       StreamFree;    /*!< Halves released by the DMA, bit n */
+  uint8_t                StreamNext;    /*!< Next half to acquire, 0 or 1      */
+  uint8_t                StreamAcquired;
+  uint8_t                StreamSilent;  /*!< Halves known to hold zeros, bit n */
+  volatile uint8_t       StreamLate;    /*!< Halves playing their substitute   */
+  volatile uint8_t       StreamMissed;  /*!< Underrun since the last acquire   */
+  volatile uint32_t      StreamUnderruns;
+  SYNTH_Sample_t         StreamBuffer[2U * SYNTH_STREAM_HALF_LENGTH] SYNTH_DMA_ALIGN;
+} SYNTH_Object_t;
+
+/**
+  * @}
+  */
+
+/** @defgroup SYNTH_Exported_Variables Synth Exported Variables
+  * @{
+  */
+
+extern SYNTH_Drv_t SYNTH_Driver;
+
 /**
   * @}
   */
@@ -129,15 +599,62 @@ typedef struct
   */
 
 int32_t SYNTH_RegisterBusIO(void *pObj, SYNTH_IO_t *pIO);
+int32_t SYNTH_RegisterPool(void *pObj, void *memory, uint32_t size);
+int32_t SYNTH_RegisterBulkPool(void *pObj, void *memory, uint32_t size);
 int32_t SYNTH_Init(void *pObj, uint32_t sample_rate, uint8_t channels);
 int32_t SYNTH_DeInit(void *pObj);
-int32_t SYNTH_PlayBuffer(void *pObj, const int16_t *buffer, uint32_t length);
+int32_t SYNTH_Reset(void *pObj);
+int32_t SYNTH_PlayBuffer(void *pObj, const SYNTH_Sample_t *buffer, uint32_t length);
+int32_t SYNTH_QueueBuffer(void *pObj, const SYNTH_Sample_t *buffer, uint32_t length,
+                          uint8_t volume, uint8_t *slot);
+int32_t SYNTH_SetBufferVolume(void *pObj, uint8_t slot, uint8_t volume);
+int32_t SYNTH_StartUsbInput(void *pObj, uint8_t volume);
+int32_t SYNTH_StopUsbInput(void *pObj);
+int32_t SYNTH_AcquireUsbBuffer(void *pObj, SYNTH_Sample_t **buffer, uint32_t *length);
+int32_t SYNTH_CommitUsbBuffer(void *pObj, uint32_t length);
+int32_t SYNTH_GetUsbFeedback(void *pObj, uint32_t *feedback);
 int32_t SYNTH_Stop(void *pObj);
+int32_t SYNTH_Pause(void *pObj);
+int32_t SYNTH_Resume(void *pObj);
+int32_t SYNTH_RegisterTxCallback(void *pObj, SYNTH_TxCallback_t callback);
+int32_t SYNTH_SetSourceRate(void *pObj, uint32_t sample_rate);
 int32_t SYNTH_SetSampleRate(void *pObj, uint32_t sample_rate);
 int32_t SYNTH_GetSampleRate(void *pObj, uint32_t *sample_rate);
 int32_t SYNTH_SetVolume(void *pObj, uint8_t volume);
 int32_t SYNTH_GetVolume(void *pObj, uint8_t *volume);
 int32_t SYNTH_Mute(void *pObj, uint8_t enable);
+int32_t SYNTH_GetStats(void *pObj, SYNTH_Stats_t *stats);
+int32_t SYNTH_ResetStats(void *pObj);
+int32_t SYNTH_Benchmark(void *pObj, uint8_t waveform_id, uint8_t voices, uint32_t blocks,
+                        SYNTH_Bench_t *result);
+
+int32_t SYNTH_StartStream(void *pObj, SYNTH_StreamCallback_t callback);
+int32_t SYNTH_AcquireBuffer(void *pObj, SYNTH_Sample_t **buffer, uint32_t *length);
+int32_t SYNTH_CommitBuffer(void *pObj);
+void    SYNTH_TxHalfCpltCallback(void *pObj);
+void    SYNTH_TxCpltCallback(void *pObj);
+int32_t SYNTH_StartRenderTask(void *pObj);
+int32_t SYNTH_PostCommand(void *pObj, const SYNTH_Command_t *command, uint32_t timeout);
+
+int32_t SYNTH_SetWaveform(void *pObj, uint8_t waveform_id);
+int32_t SYNTH_SetEnvelope(void *pObj, const SYNTH_Envelope_t *envelope);
+int32_t SYNTH_SetFilter(void *pObj, uint8_t stage, const SYNTH_Filter_t *filter);
+int32_t SYNTH_LoadWavetable(void *pObj, uint8_t waveform_id, const int16_t *table);
+int32_t SYNTH_LoadSampler(void *pObj, uint8_t waveform_id, const SYNTH_Sampler_t *sampler);
+int32_t SYNTH_SetDelay(void *pObj, const SYNTH_Delay_t *delay);
+int32_t SYNTH_SetChorus(void *pObj, const SYNTH_Chorus_t *chorus);
+int32_t SYNTH_SetReverb(void *pObj, const SYNTH_Reverb_t *reverb);
+int32_t SYNTH_SetLfo(void *pObj, uint8_t lfo, const SYNTH_Lfo_t *settings);
+int32_t SYNTH_SetModRoute(void *pObj, uint8_t slot, const SYNTH_ModRoute_t *route);
+int32_t SYNTH_LoadPreset(void *pObj, const void *data, uint32_t size);
+int32_t SYNTH_SavePreset(void *pObj, SYNTH_Preset_t *preset);
+int32_t SYNTH_SetFrequency(void *pObj, float frequency);
+int32_t SYNTH_NoteOn(void *pObj, uint8_t note, uint8_t velocity);
+int32_t SYNTH_NoteOff(void *pObj, uint8_t note);
+int32_t SYNTH_PostEvent(void *pObj, const SYNTH_Event_t *event);
+int32_t SYNTH_Render(void *pObj, SYNTH_Sample_t *buffer, uint32_t length);
+int32_t SYNTH_RenderSecondary(void *pObj);
+int32_t SYNTH_GetActiveVoices(void *pObj, uint8_t *count);
 
 /**
   * @}
@@ -0,0 +1,210 @@
+/**
+  ******************************************************************************
+  * @file    synth_dsp.h
+  * @author  Cullen Sharp
+  * @brief   This file contains the DSP primitives used by the Synth mixer.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2025
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef SYNTH_DSP_H
+#define SYNTH_DSP_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/** @addtogroup Components
+  * @{
+  */
+
+/** @addtogroup Synth
+  * @{
+  */
+
+/** @defgroup SYNTH_DSP_Exported_Constants Synth DSP Exported Constants
+  * @{
+  */
+
+/* ARMv7E-M SIMD/DSP instructions are used when the core has them (M4, M7,
+   M33 with DSP), the portable C versions below produce identical results */
+#ifndef SYNTH_USE_DSP
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define SYNTH_USE_DSP               1U
+#else
+#define SYNTH_USE_DSP               0U
+#endif
+#endif
+
+/* CMSIS-DSP library kernels (arm_math.h) where the driver has an
+   equivalent, off unless enabled in synth_conf.h */
+#ifndef SYNTH_USE_CMSIS_DSP
+#define SYNTH_USE_CMSIS_DSP         0U
+#endif
+
+/* Biquad coefficients are Q30, the CMSIS DF1 postShift of 1 */
+#define SYNTH_BIQUAD_SHIFT          1U
+
+/**
+  * @}
+  */
+
+/** @defgroup SYNTH_DSP_Exported_Macros Synth DSP Exported Macros
+  * @{
+  */
+
+#if (SYNTH_USE_DSP == 1U)
+
+#include "cmsis_compiler.h"
+
+/* Saturate to int16_t */
+#define SYNTH_SSAT16(x)             __SSAT((x), 16)
+
+/* Saturate to the signed 24-bit range */
+#define SYNTH_SSAT24(x)             __SSAT((x), 24)
+
+/* acc + ((a * b[15:0]) >> 16) */
+#define SYNTH_SMLAWB(a, b, acc)     __SMLAWB((a), (b), (acc))
+
+/* Pack two int16_t into one word, lo in the bottom halfword */
+#define SYNTH_PACK16(lo, hi)        __PKHBT((lo), (hi), 16)
+
+/* Word store that tolerates a 2-byte aligned int16_t buffer */
+#define SYNTH_WRITE32(p, v)         __UNALIGNED_UINT32_WRITE((p), (v))
+
+#else
+
+static inline int32_t SYNTH_SSAT16(int32_t x)
+{
+  return (x > 32767) ? 32767 : ((x < -32768) ? -32768 : x);
+}
+
+static inline int32_t SYNTH_SSAT24(int32_t x)
+{
+  return (x > 8388607) ? 8388607 : ((x < -8388608) ? -8388608 : x);
+}
+
+static inline int32_t SYNTH_SMLAWB(int32_t a, int32_t b, int32_t acc)
+{
+  return acc + (int32_t)(((int64_t)a * (int16_t)b) >> 16);
+}
+
+static inline uint32_t SYNTH_PACK16(int32_t lo, int32_t hi)
+{
+  return ((uint32_t)lo & 0xFFFFU) | ((uint32_t)hi << 16);
+}
+
+static inline void SYNTH_WRITE32(void *p, uint32_t v)
+{
+  uint16_t *dst = (uint16_t *)p;
+
+  /* Little-endian, matching the packed halfword order */
+  dst[0] = (uint16_t)v;
+  dst[1] = (uint16_t)(v >> 16);
+}
+
+#endif /* SYNTH_USE_DSP */
+
+/* Saturate a 64-bit intermediate to int32_t, no single instruction does it */
+static inline int32_t SYNTH_SSAT32(int64_t x)
+{
+  return (x > INT32_MAX) ? INT32_MAX : ((x < INT32_MIN) ? INT32_MIN : (int32_t)x);
+}
+
+#if (SYNTH_USE_CMSIS_DSP == 1U)
+
+#include "arm_math.h"
+
+/* One biquad section in place, coeffs and state in the CMSIS DF1 layout */
+static inline void SYNTH_BiquadDF1(int32_t *state, const int32_t *coeffs,
+                                   int32_t *buffer, uint32_t length)
+{
+  arm_biquad_casd_df1_inst_q31 S;
+
+  S.numStages = 1;
+  S.pState    = state;
+  S.pCoeffs   = (q31_t *)coeffs;
+  S.postShift = SYNTH_BIQUAD_SHIFT;
+  arm_biquad_cascade_df1_q31(&S, buffer, buffer, length);
+}
+
+#else
+
+/* Same arithmetic as arm_biquad_cascade_df1_q31: coeffs {b0, b1, b2, a1, a2}
+   with the feedback terms added, state {x1, x2, y1, y2}, 64-bit accumulator */
+static inline void SYNTH_BiquadDF1(int32_t *state, const int32_t *coeffs,
+                                   int32_t *buffer, uint32_t length)
+{
+  int32_t  x1 = state[0];
+  int32_t  x2 = state[1];
+  int32_t  y1 = state[2];
+  int32_t  y2 = state[3];
+  int64_t  acc;
+  int32_t  x0;
+  uint32_t i;
+
+  for (i = 0; i < length; i++)
+  {
+    x0   = buffer[i];
+    acc  = (int64_t)coeffs[0] * x0;
+    acc += (int64_t)coeffs[1] * x1;
+    acc += (int64_t)coeffs[2] * x2;
+    acc += (int64_t)coeffs[3] * y1;
+    acc += (int64_t)coeffs[4] * y2;
+
+    x2 = x1;
+    x1 = x0;
+    y2 = y1;
+    y1 = (int32_t)(acc >> (31U - SYNTH_BIQUAD_SHIFT));
+    buffer[i] = y1;
+  }
+
+  state[0] = x1;
+  state[1] = x2;
+  state[2] = y1;
+  state[3] = y2;
+}
+
+#endif /* SYNTH_USE_CMSIS_DSP */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYNTH_DSP_H */
+
+/************************ (C) COPYRIGHT Embedded Systems Team *****END OF FILE****/
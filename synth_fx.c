@@ -0,0 +1,756 @@
+/**
+  ******************************************************************************
+  * @file    synth_fx.c
+  * @author  Cullen Sharp
+  * @brief   This file provides the master bus effects for the Synth.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2025
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "synth.h"
+#include "synth_wavetable.h"
+#include <stddef.h>
+#include <string.h>  /* For memcpy */
+
+#if SYNTH_USE_FX
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/** @addtogroup Components
+  * @{
+  */
+
+/** @addtogroup Synth
+  * @{
+  */
+
+/* Private macros ------------------------------------------------------------*/
+/* Percent to Q15 */
+#define SYNTH_FX_PERCENT(p)     (((int32_t)(p) * 32767) / 100)
+
+/* Chorus sweeps around this delay */
+#define SYNTH_CHORUS_BASE_MS    15U
+
+/* Reverb input level and the fixed allpass feedback (Q15) */
+#define SYNTH_REVERB_INPUT      1638
+#define SYNTH_REVERB_ALLPASS    16384
+
+/* Private variables ---------------------------------------------------------*/
+#if (SYNTH_USE_REVERB == 1U)
+/* Freeverb tunings in samples at 44.1 kHz, scaled to the output rate */
+static const uint16_t SynthCombTuning[SYNTH_REVERB_COMBS] = { 1116U, 1188U, 1277U, 1356U };
+static const uint16_t SynthAllpassTuning[SYNTH_REVERB_ALLPASSES] = { 556U, 441U };
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+static int32_t SYNTH_DelayAlloc(SYNTH_DelayLine_t *line, SYNTH_Pool_t *pool, uint32_t samples);
+static void    SYNTH_DelayFree(SYNTH_DelayLine_t *line, SYNTH_Pool_t *pool);
+static void    SYNTH_DelayRead(const SYNTH_DelayLine_t *line, uint32_t delay, int32_t *dst,
+                               uint32_t count);
+static void    SYNTH_DelayWrite(SYNTH_DelayLine_t *line, const int32_t *src, uint32_t count);
+static uint32_t SYNTH_DelayTap(const SYNTH_DelayLine_t *line, uint32_t samples, uint32_t frames);
+static inline int32_t SYNTH_FxMul(int32_t x, int32_t q15);
+static uint32_t SYNTH_FxRepeats(int32_t feedback);
+static uint32_t SYNTH_FxTail(const SYNTH_Fx_t *fx);
+#if (SYNTH_USE_CHORUS == 1U)
+static void    SYNTH_ChorusProcess(SYNTH_Fx_t *fx, int32_t *mix, uint32_t frames,
+                                   uint32_t sample_rate);
+static int32_t SYNTH_ChorusDelay(const SYNTH_Chorus_t *chorus, uint32_t phase,
+                                 uint32_t sample_rate);
+#endif
+#if (SYNTH_USE_DELAY == 1U)
+static void    SYNTH_EchoProcess(SYNTH_Fx_t *fx, int32_t *mix, uint32_t frames,
+                                 uint32_t sample_rate);
+#endif
+#if (SYNTH_USE_REVERB == 1U)
+static void    SYNTH_ReverbFree(SYNTH_Fx_t *fx, SYNTH_Pool_t *pool);
+static void    SYNTH_ReverbProcess(SYNTH_Fx_t *fx, int32_t *mix, uint32_t frames,
+                                   uint32_t sample_rate);
+#endif
+
+/** @defgroup SYNTH_Fx_Exported_Functions Synth Fx Exported Functions
+  * @{
+  */
+
+#if (SYNTH_USE_DELAY == 1U)
+/**
+  * @brief  Configure the echo and size its delay line
+  * @note   Leaves the effect disabled, the caller enables it once the
+  *         state is visible to the render context. Disabling returns the
+  *         line to the pool.
+  * @param  fx           Pointer to effect state
+  * @param  pool         Bulk pool backing the delay lines
+  * @param  delay        Pointer to echo settings
+  * @param  sample_rate  Output rate in Hz
+  * @retval Synth status, error when the pool cannot hold the line
+  */
+int32_t SYNTH_FxSetDelay(SYNTH_Fx_t *fx, SYNTH_Pool_t *pool, const SYNTH_Delay_t *delay,
+                         uint32_t sample_rate)
+{
+  uint32_t samples;
+
+  if ((delay == NULL) || (delay->Feedback > 95U) || (delay->Mix > 100U))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  fx->Delay        = *delay;
+  fx->Delay.Enable = 0;
+
+  if (delay->Enable == 0U)
+  {
+    SYNTH_DelayFree(&fx->DelayLine, pool);
+    return SYNTH_STATUS_OK;
+  }
+
+  samples = (uint32_t)(((uint64_t)delay->Time * sample_rate) / 1000U);
+  fx->DelayTail = ((samples + SYNTH_STREAM_BLOCK_SIZE) *
+                   SYNTH_FxRepeats(SYNTH_FX_PERCENT(delay->Feedback)));
+  if (SYNTH_DelayAlloc(&fx->DelayLine, pool,
+                       (samples > SYNTH_STREAM_BLOCK_SIZE) ? samples : SYNTH_STREAM_BLOCK_SIZE) !=
+      SYNTH_STATUS_OK)
+  {
+    SYNTH_DelayFree(&fx->DelayLine, pool);
+    return SYNTH_STATUS_ERROR;
+  }
+
+  return SYNTH_STATUS_OK;
+}
+#endif
+
+#if (SYNTH_USE_CHORUS == 1U)
+/**
+  * @brief  Configure the chorus and size its delay line
+  * @note   Leaves the effect disabled, see SYNTH_FxSetDelay.
+  * @param  fx           Pointer to effect state
+  * @param  pool         Bulk pool backing the delay lines
+  * @param  chorus       Pointer to chorus settings
+  * @param  sample_rate  Output rate in Hz
+  * @retval Synth status
+  */
+int32_t SYNTH_FxSetChorus(SYNTH_Fx_t *fx, SYNTH_Pool_t *pool, const SYNTH_Chorus_t *chorus,
+                          uint32_t sample_rate)
+{
+  uint32_t samples;
+
+  /* The limits bound the sweep within a block, see SYNTH_ChorusProcess */
+  if ((chorus == NULL) || (chorus->Rate > 50U) || (chorus->Depth > 50U) || (chorus->Mix > 100U))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  fx->Chorus        = *chorus;
+  fx->Chorus.Enable = 0;
+
+  if (chorus->Enable == 0U)
+  {
+    SYNTH_DelayFree(&fx->ChorusLine, pool);
+    return SYNTH_STATUS_OK;
+  }
+
+  fx->ChorusPhase = 0;
+  fx->ChorusDelay = SYNTH_ChorusDelay(chorus, 0, sample_rate);
+
+  samples = (((SYNTH_CHORUS_BASE_MS * 10U) + chorus->Depth) * sample_rate) / 10000U;
+  fx->ChorusTail = samples + (2U * SYNTH_STREAM_BLOCK_SIZE);
+  if (SYNTH_DelayAlloc(&fx->ChorusLine, pool, samples + (2U * SYNTH_STREAM_BLOCK_SIZE) + 2U) !=
+      SYNTH_STATUS_OK)
+  {
+    SYNTH_DelayFree(&fx->ChorusLine, pool);
+    return SYNTH_STATUS_ERROR;
+  }
+
+  return SYNTH_STATUS_OK;
+}
+#endif
+
+#if (SYNTH_USE_REVERB == 1U)
+/**
+  * @brief  Configure the reverb and size its comb and allpass lines
+  * @note   Leaves the effect disabled, see SYNTH_FxSetDelay. Lines are sized
+  *         for the current rate, configure again after raising it.
+  * @param  fx           Pointer to effect state
+  * @param  pool         Bulk pool backing the delay lines
+  * @param  reverb       Pointer to reverb settings
+  * @param  sample_rate  Output rate in Hz
+  * @retval Synth status
+  */
+int32_t SYNTH_FxSetReverb(SYNTH_Fx_t *fx, SYNTH_Pool_t *pool, const SYNTH_Reverb_t *reverb,
+                          uint32_t sample_rate)
+{
+  uint32_t samples;
+  uint32_t i;
+
+  if ((reverb == NULL) || (reverb->Size > 100U) || (reverb->Damp > 100U) || (reverb->Mix > 100U))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  fx->Reverb        = *reverb;
+  fx->Reverb.Enable = 0;
+  fx->ReverbTail    = 0;
+
+  for (i = 0; i < SYNTH_REVERB_COMBS; i++)
+  {
+    fx->CombStore[i] = 0;
+  }
+
+  if (reverb->Enable == 0U)
+  {
+    SYNTH_ReverbFree(fx, pool);
+    return SYNTH_STATUS_OK;
+  }
+
+  for (i = 0; i < SYNTH_REVERB_COMBS; i++)
+  {
+    samples = ((uint32_t)SynthCombTuning[i] * sample_rate) / 44100U;
+    if (samples > fx->ReverbTail)
+    {
+      fx->ReverbTail = samples;
+    }
+    if (SYNTH_DelayAlloc(&fx->Combs[i], pool, samples + SYNTH_STREAM_BLOCK_SIZE) != SYNTH_STATUS_OK)
+    {
+      SYNTH_ReverbFree(fx, pool);
+      return SYNTH_STATUS_ERROR;
+    }
+  }
+
+  /* Longest comb until its feedback reached -60 dB, then the allpasses */
+  fx->ReverbTail = (fx->ReverbTail + SYNTH_STREAM_BLOCK_SIZE) *
+                   SYNTH_FxRepeats(22938 + ((int32_t)reverb->Size * 9175) / 100);
+
+  for (i = 0; i < SYNTH_REVERB_ALLPASSES; i++)
+  {
+    samples = ((uint32_t)SynthAllpassTuning[i] * sample_rate) / 44100U;
+    fx->ReverbTail += (samples + SYNTH_STREAM_BLOCK_SIZE) * SYNTH_FxRepeats(SYNTH_REVERB_ALLPASS);
+    if (SYNTH_DelayAlloc(&fx->Allpasses[i], pool, samples + SYNTH_STREAM_BLOCK_SIZE) !=
+        SYNTH_STATUS_OK)
+    {
+      SYNTH_ReverbFree(fx, pool);
+      return SYNTH_STATUS_ERROR;
+    }
+  }
+
+  return SYNTH_STATUS_OK;
+}
+#endif
+
+/**
+  * @brief  Check whether any effect still has a tail to render
+  * @note   An enabled effect only counts until its tail has decayed after
+  *         the last non-zero input, see SYNTH_FxProcess, so a silent bus
+  *         lets the render pass idle.
+  * @param  fx  Pointer to effect state
+  * @retval 1 if the master bus has effect tails to render
+  */
+uint8_t SYNTH_FxActive(const SYNTH_Fx_t *fx)
+{
+  uint8_t active = 0;
+
+  if (fx->Tail == 0U)
+  {
+    return 0;
+  }
+
+#if (SYNTH_USE_DELAY == 1U)
+  active |= fx->Delay.Enable;
+#endif
+#if (SYNTH_USE_CHORUS == 1U)
+  active |= fx->Chorus.Enable;
+#endif
+#if (SYNTH_USE_REVERB == 1U)
+  active |= fx->Reverb.Enable;
+#endif
+
+  return (active != 0U) ? 1U : 0U;
+}
+
+/**
+  * @brief  Run the enabled effects over one mono block
+  * @note   Chorus, then echo, then reverb. Each delay tap is copied in one
+  *         run per segment into SRAM and processed there, so external
+  *         memory only sees block-sized sequential bursts. Non-zero input
+  *         restarts the tail countdown, silent input runs it down.
+  * @param  fx           Pointer to effect state
+  * @param  mix          Pointer to mono accumulator, processed in place
+  * @param  frames       Number of frames, at most SYNTH_STREAM_BLOCK_SIZE
+  * @param  sample_rate  Output rate in Hz
+  * @retval None
+  */
+void SYNTH_FxProcess(SYNTH_Fx_t *fx, int32_t *mix, uint32_t frames, uint32_t sample_rate)
+{
+  uint32_t i;
+
+  for (i = 0; i < frames; i++)
+  {
+    if (mix[i] != 0)
+    {
+      break;
+    }
+  }
+
+  if (i < frames)
+  {
+    fx->Tail = SYNTH_FxTail(fx);
+  }
+  else
+  {
+    fx->Tail = (fx->Tail > frames) ? (fx->Tail - frames) : 0U;
+  }
+
+#if (SYNTH_USE_CHORUS == 1U)
+  if (fx->Chorus.Enable)
+  {
+    SYNTH_ChorusProcess(fx, mix, frames, sample_rate);
+  }
+#endif
+#if (SYNTH_USE_DELAY == 1U)
+  if (fx->Delay.Enable)
+  {
+    SYNTH_EchoProcess(fx, mix, frames, sample_rate);
+  }
+#endif
+#if (SYNTH_USE_REVERB == 1U)
+  if (fx->Reverb.Enable)
+  {
+    SYNTH_ReverbProcess(fx, mix, frames, sample_rate);
+  }
+#endif
+}
+
+/**
+  * @}
+  */
+
+/** @defgroup SYNTH_Fx_Private_Functions Synth Fx Private Functions
+  * @{
+  */
+
+/**
+  * @brief  Grow a delay line to hold at least the given samples and clear it
+  * @param  line     Pointer to delay line
+  * @param  pool     Bulk pool
+  * @param  samples  Samples required
+  * @retval Synth status
+  */
+static int32_t SYNTH_DelayAlloc(SYNTH_DelayLine_t *line, SYNTH_Pool_t *pool, uint32_t samples)
+{
+  uint32_t count = (samples + SYNTH_FX_SEGMENT_SIZE - 1U) / SYNTH_FX_SEGMENT_SIZE;
+  uint32_t i;
+
+  if (count > SYNTH_FX_MAX_SEGMENTS)
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  while (line->Count < count)
+  {
+    line->Segments[line->Count] = (int32_t *)SYNTH_PoolAlloc(pool);
+    if (line->Segments[line->Count] == NULL)
+    {
+      return SYNTH_STATUS_ERROR;
+    }
+    line->Count++;
+  }
+
+  for (i = 0; i < line->Count; i++)
+  {
+    memset(line->Segments[i], 0, SYNTH_FX_SEGMENT_SIZE * sizeof(int32_t));
+  }
+
+  line->Length = line->Count * SYNTH_FX_SEGMENT_SIZE;
+  line->Write  = 0;
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Return every segment of a delay line to the pool
+  * @param  line  Pointer to delay line
+  * @param  pool  Bulk pool
+  * @retval None
+  */
+static void SYNTH_DelayFree(SYNTH_DelayLine_t *line, SYNTH_Pool_t *pool)
+{
+  while (line->Count > 0U)
+  {
+    line->Count--;
+    (void)SYNTH_PoolFree(pool, line->Segments[line->Count]);
+  }
+
+  line->Length = 0;
+  line->Write  = 0;
+}
+
+/**
+  * @brief  Copy consecutive samples out of a delay line
+  * @param  line   Pointer to delay line
+  * @param  delay  Samples behind the write position of the first one
+  * @param  dst    Destination
+  * @param  count  Number of samples
+  * @retval None
+  */
+static void SYNTH_DelayRead(const SYNTH_DelayLine_t *line, uint32_t delay, int32_t *dst,
+                            uint32_t count)
+{
+  uint32_t pos = (line->Write >= delay) ? (line->Write - delay) :
+                                          (line->Write + line->Length - delay);
+  uint32_t off;
+  uint32_t run;
+
+  while (count > 0U)
+  {
+    off = pos % SYNTH_FX_SEGMENT_SIZE;
+    run = SYNTH_FX_SEGMENT_SIZE - off;
+    run = (run > count) ? count : run;
+
+    memcpy(dst, &line->Segments[pos / SYNTH_FX_SEGMENT_SIZE][off], run * sizeof(int32_t));
+    dst   += run;
+    count -= run;
+    pos   += run;
+    if (pos >= line->Length)
+    {
+      pos = 0;
+    }
+  }
+}
+
+/**
+  * @brief  Append samples to a delay line
+  * @param  line   Pointer to delay line
+  * @param  src    Source
+  * @param  count  Number of samples
+  * @retval None
+  */
+static void SYNTH_DelayWrite(SYNTH_DelayLine_t *line, const int32_t *src, uint32_t count)
+{
+  uint32_t pos = line->Write;
+  uint32_t off;
+  uint32_t run;
+
+  while (count > 0U)
+  {
+    off = pos % SYNTH_FX_SEGMENT_SIZE;
+    run = SYNTH_FX_SEGMENT_SIZE - off;
+    run = (run > count) ? count : run;
+
+    memcpy(&line->Segments[pos / SYNTH_FX_SEGMENT_SIZE][off], src, run * sizeof(int32_t));
+    src   += run;
+    count -= run;
+    pos   += run;
+    if (pos >= line->Length)
+    {
+      pos = 0;
+    }
+  }
+
+  line->Write = pos;
+}
+
+/**
+  * @brief  Clamp a feedback tap to what block processing can serve
+  * @note   A tap of at least one block is fully written before the block
+  *         that reads it, so each block reads once and then writes once.
+  * @param  line     Pointer to delay line
+  * @param  samples  Requested delay in samples
+  * @param  frames   Block length
+  * @retval Tap delay in samples
+  */
+static uint32_t SYNTH_DelayTap(const SYNTH_DelayLine_t *line, uint32_t samples, uint32_t frames)
+{
+  samples = (samples < frames) ? frames : samples;
+  return (samples > line->Length) ? line->Length : samples;
+}
+
+/**
+  * @brief  Multiply a mix sample by a Q15 factor
+  * @param  x    Mix sample
+  * @param  q15  Factor
+  * @retval Product
+  */
+static inline int32_t SYNTH_FxMul(int32_t x, int32_t q15)
+{
+  return (int32_t)(((int64_t)x * q15) >> 15);
+}
+
+/**
+  * @brief  Passes through a feedback loop until it falls by 60 dB
+  * @param  feedback  Q15 loop gain, below 1.0
+  * @retval Number of passes, at least 1
+  */
+static uint32_t SYNTH_FxRepeats(int32_t feedback)
+{
+  int32_t  level = 32767;
+  uint32_t n = 0;
+
+  while (level > 32)
+  {
+    level = SYNTH_FxMul(level, feedback);
+    n++;
+  }
+
+  return n;
+}
+
+/**
+  * @brief  Longest tail among the enabled effects
+  * @param  fx  Pointer to effect state
+  * @retval Samples an input stays audible after it stops
+  */
+static uint32_t SYNTH_FxTail(const SYNTH_Fx_t *fx)
+{
+  uint32_t tail = 0;
+
+#if (SYNTH_USE_DELAY == 1U)
+  if (fx->Delay.Enable && (fx->DelayTail > tail))
+  {
+    tail = fx->DelayTail;
+  }
+#endif
+#if (SYNTH_USE_CHORUS == 1U)
+  if (fx->Chorus.Enable && (fx->ChorusTail > tail))
+  {
+    tail = fx->ChorusTail;
+  }
+#endif
+#if (SYNTH_USE_REVERB == 1U)
+  if (fx->Reverb.Enable && (fx->ReverbTail > tail))
+  {
+    tail = fx->ReverbTail;
+  }
+#endif
+
+  return tail;
+}
+
+#if (SYNTH_USE_CHORUS == 1U)
+/**
+  * @brief  Chorus delay for an LFO phase
+  * @param  chorus       Pointer to chorus settings
+  * @param  phase        Sweep phase, full scale is one period
+  * @param  sample_rate  Output rate in Hz
+  * @retval Delay in Q16 samples
+  */
+static int32_t SYNTH_ChorusDelay(const SYNTH_Chorus_t *chorus, uint32_t phase,
+                                 uint32_t sample_rate)
+{
+  int32_t base  = (int32_t)((SYNTH_CHORUS_BASE_MS * sample_rate) / 1000U);
+  int32_t depth = (int32_t)(((uint32_t)chorus->Depth * sample_rate) / 10000U);
+  int32_t v     = SYNTH_SineTable[phase >> (32U - SYNTH_WAVETABLE_BITS)];
+
+  return (base << 16) + (depth * (v + 32768));
+}
+
+/**
+  * @brief  Swept delay mixed with the dry signal
+  * @note   The sweep is evaluated at block rate and the delay ramps
+  *         linearly in between. The input is written first so the read
+  *         window covering the whole ramp is one copy.
+  * @param  fx           Pointer to effect state
+  * @param  mix          Pointer to mono accumulator
+  * @param  frames       Number of frames
+  * @param  sample_rate  Output rate in Hz
+  * @retval None
+  */
+static void SYNTH_ChorusProcess(SYNTH_Fx_t *fx, int32_t *mix, uint32_t frames,
+                                uint32_t sample_rate)
+{
+  const int32_t *w = fx->Work;
+  int32_t  wet = SYNTH_FX_PERCENT(fx->Chorus.Mix);
+  int32_t  d0  = fx->ChorusDelay;
+  int32_t  d1;
+  int32_t  d;
+  int32_t  step;
+  int32_t  p;
+  uint32_t dmax;
+  uint32_t dmin;
+  uint32_t span;
+  uint32_t idx;
+  uint32_t i;
+
+  fx->ChorusPhase += (uint32_t)((((uint64_t)fx->Chorus.Rate << 32) / (10ULL * sample_rate)) *
+                                frames);
+  d1 = SYNTH_ChorusDelay(&fx->Chorus, fx->ChorusPhase, sample_rate);
+
+  dmax = ((uint32_t)((d0 > d1) ? d0 : d1) >> 16) + 1U;
+  dmin = (uint32_t)((d0 < d1) ? d0 : d1) >> 16;
+  span = frames + dmax - dmin + 1U;
+  if ((span > (2U * SYNTH_STREAM_BLOCK_SIZE)) || ((frames + dmax) > fx->ChorusLine.Length))
+  {
+    /* Out of range after a rate change, hold the dry signal */
+    fx->ChorusDelay = d1;
+    return;
+  }
+
+  SYNTH_DelayWrite(&fx->ChorusLine, mix, frames);
+  SYNTH_DelayRead(&fx->ChorusLine, frames + dmax, fx->Work, span);
+
+  step = (d1 - d0) / (int32_t)frames;
+  d    = d0;
+  for (i = 0; i < frames; i++)
+  {
+    p   = (int32_t)((i + dmax) << 16) - d;
+    idx = (uint32_t)p >> 16;
+    p  &= 0xFFFF;
+
+    mix[i] += SYNTH_FxMul(w[idx] + (int32_t)(((int64_t)(w[idx + 1U] - w[idx]) * p) >> 16), wet);
+    d += step;
+  }
+
+  fx->ChorusDelay = d1;
+}
+#endif
+
+#if (SYNTH_USE_DELAY == 1U)
+/**
+  * @brief  Feedback echo
+  * @param  fx           Pointer to effect state
+  * @param  mix          Pointer to mono accumulator
+  * @param  frames       Number of frames
+  * @param  sample_rate  Output rate in Hz
+  * @retval None
+  */
+static void SYNTH_EchoProcess(SYNTH_Fx_t *fx, int32_t *mix, uint32_t frames,
+                              uint32_t sample_rate)
+{
+  int32_t  *w  = fx->Work;
+  int32_t  fb  = SYNTH_FX_PERCENT(fx->Delay.Feedback);
+  int32_t  wet = SYNTH_FX_PERCENT(fx->Delay.Mix);
+  int32_t  x;
+  uint32_t tap;
+  uint32_t i;
+
+  tap = SYNTH_DelayTap(&fx->DelayLine,
+                       (uint32_t)(((uint64_t)fx->Delay.Time * sample_rate) / 1000U), frames);
+  SYNTH_DelayRead(&fx->DelayLine, tap, w, frames);
+
+  for (i = 0; i < frames; i++)
+  {
+    x      = mix[i];
+    mix[i] = x + SYNTH_FxMul(w[i], wet);
+    w[i]   = x + SYNTH_FxMul(w[i], fb);
+  }
+
+  SYNTH_DelayWrite(&fx->DelayLine, w, frames);
+}
+#endif
+
+#if (SYNTH_USE_REVERB == 1U)
+/**
+  * @brief  Return every comb and allpass line to the pool
+  * @param  fx    Pointer to effect state
+  * @param  pool  Bulk pool
+  * @retval None
+  */
+static void SYNTH_ReverbFree(SYNTH_Fx_t *fx, SYNTH_Pool_t *pool)
+{
+  uint32_t i;
+
+  for (i = 0; i < SYNTH_REVERB_COMBS; i++)
+  {
+    SYNTH_DelayFree(&fx->Combs[i], pool);
+  }
+
+  for (i = 0; i < SYNTH_REVERB_ALLPASSES; i++)
+  {
+    SYNTH_DelayFree(&fx->Allpasses[i], pool);
+  }
+}
+
+/**
+  * @brief  Mono Freeverb: parallel damped combs into serial allpasses
+  * @param  fx           Pointer to effect state
+  * @param  mix          Pointer to mono accumulator
+  * @param  frames       Number of frames
+  * @param  sample_rate  Output rate in Hz
+  * @retval None
+  */
+static void SYNTH_ReverbProcess(SYNTH_Fx_t *fx, int32_t *mix, uint32_t frames,
+                                uint32_t sample_rate)
+{
+  int32_t  *w   = fx->Work;
+  int32_t  *acc = fx->Wet;
+  int32_t  fb   = 22938 + ((int32_t)fx->Reverb.Size * 9175) / 100;  /*!< 0.70 to 0.98 */
+  int32_t  damp = ((int32_t)fx->Reverb.Damp * 13107) / 100;        /*!< 0 to 0.40    */
+  int32_t  wet  = SYNTH_FX_PERCENT(fx->Reverb.Mix);
+  int32_t  store;
+  int32_t  out;
+  uint32_t tap;
+  uint32_t k;
+  uint32_t i;
+
+  memset(acc, 0, frames * sizeof(int32_t));
+
+  for (k = 0; k < SYNTH_REVERB_COMBS; k++)
+  {
+    tap = SYNTH_DelayTap(&fx->Combs[k],
+                         ((uint32_t)SynthCombTuning[k] * sample_rate) / 44100U, frames);
+    SYNTH_DelayRead(&fx->Combs[k], tap, w, frames);
+
+    store = fx->CombStore[k];
+    for (i = 0; i < frames; i++)
+    {
+      out    = w[i];
+      store  = SYNTH_FxMul(out, 32767 - damp) + SYNTH_FxMul(store, damp);
+      w[i]   = SYNTH_FxMul(mix[i], SYNTH_REVERB_INPUT) + SYNTH_FxMul(store, fb);
+      acc[i] += out;
+    }
+    fx->CombStore[k] = store;
+
+    SYNTH_DelayWrite(&fx->Combs[k], w, frames);
+  }
+
+  for (k = 0; k < SYNTH_REVERB_ALLPASSES; k++)
+  {
+    tap = SYNTH_DelayTap(&fx->Allpasses[k],
+                         ((uint32_t)SynthAllpassTuning[k] * sample_rate) / 44100U, frames);
+    SYNTH_DelayRead(&fx->Allpasses[k], tap, w, frames);
+
+    for (i = 0; i < frames; i++)
+    {
+      out    = w[i] - acc[i];
+      w[i]   = acc[i] + SYNTH_FxMul(w[i], SYNTH_REVERB_ALLPASS);
+      acc[i] = out;
+    }
+
+    SYNTH_DelayWrite(&fx->Allpasses[k], w, frames);
+  }
+
+  for (i = 0; i < frames; i++)
+  {
+    mix[i] += SYNTH_FxMul(acc[i], wet);
+  }
+}
+#endif
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* SYNTH_USE_FX */
+
+/************************ (C) COPYRIGHT Embedded Systems Team *****END OF FILE****/
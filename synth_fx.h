@@ -0,0 +1,188 @@
+/**
+  ******************************************************************************
+  * @file    synth_fx.h
+  * @author  Cullen Sharp
+  * @brief   This file contains the master effect definitions.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2025
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef SYNTH_FX_H
+#define SYNTH_FX_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "synth_conf.h"
+#include "synth_pool.h"
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/** @addtogroup Components
+  * @{
+  */
+
+/** @addtogroup Synth
+  * @{
+  */
+
+/** @defgroup SYNTH_Fx_Exported_Constants Synth Fx Exported Constants
+  * @{
+  */
+
+/* Any master effect compiled in */
+#define SYNTH_USE_FX                ((SYNTH_USE_DELAY == 1U) || (SYNTH_USE_CHORUS == 1U) || \
+                                     (SYNTH_USE_REVERB == 1U))
+
+/* Delay line segment, one bulk pool block */
+#define SYNTH_FX_SEGMENT_SIZE       (SYNTH_BULK_BLOCK_SIZE / sizeof(int32_t))
+
+/* Reverb network, mono Freeverb layout */
+#define SYNTH_REVERB_COMBS          4U
+#define SYNTH_REVERB_ALLPASSES      2U
+
+/**
+  * @}
+  */
+
+/** @defgroup SYNTH_Fx_Exported_Types Synth Fx Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Delay line over bulk pool blocks
+  * @note   Segments are used in order as one ring, taps are copied in runs
+  *         that end only at a segment boundary.
+  */
+typedef struct
+{
+  int32_t  *Segments[SYNTH_FX_MAX_SEGMENTS];
+  uint32_t Count;        /*!< Segments held                               */
+  uint32_t Length;       /*!< Samples, Count * SYNTH_FX_SEGMENT_SIZE      */
+  uint32_t Write;        /*!< Next sample written                         */
+} SYNTH_DelayLine_t;
+
+/**
+  * @brief  Echo settings
+  */
+typedef struct
+{
+  uint8_t  Enable;
+  uint16_t Time;         /*!< Delay in ms                                 */
+  uint8_t  Feedback;     /*!< Percent fed back, 0-95                      */
+  uint8_t  Mix;          /*!< Wet level, percent                          */
+} SYNTH_Delay_t;
+
+/**
+  * @brief  Chorus settings
+  */
+typedef struct
+{
+  uint8_t  Enable;
+  uint8_t  Rate;         /*!< Sweep rate in 0.1 Hz, up to 50              */
+  uint8_t  Depth;        /*!< Sweep depth in 0.1 ms, up to 50             */
+  uint8_t  Mix;          /*!< Wet level, percent                          */
+} SYNTH_Chorus_t;
+
+/**
+  * @brief  Reverb settings
+  */
+typedef struct
+{
+  uint8_t  Enable;
+  uint8_t  Size;         /*!< Room size, percent                          */
+  uint8_t  Damp;         /*!< High frequency damping, percent             */
+  uint8_t  Mix;          /*!< Wet level, percent                          */
+} SYNTH_Reverb_t;
+
+/**
+  * @brief  Master effect state
+  */
+typedef struct
+{
+#if (SYNTH_USE_DELAY == 1U)
+  SYNTH_Delay_t          Delay;
+  SYNTH_DelayLine_t      DelayLine;
+  uint32_t               DelayTail;     /*!< Samples until the echoes reach -60 dB */
+#endif
+#if (SYNTH_USE_CHORUS == 1U)
+  SYNTH_Chorus_t         Chorus;
+  SYNTH_DelayLine_t      ChorusLine;
+  uint32_t               ChorusTail;
+  uint32_t               ChorusPhase;
+  int32_t                ChorusDelay;   /*!< Q16 samples reached by the last block */
+#endif
+#if (SYNTH_USE_REVERB == 1U)
+  SYNTH_Reverb_t         Reverb;
+  SYNTH_DelayLine_t      Combs[SYNTH_REVERB_COMBS];
+  int32_t                CombStore[SYNTH_REVERB_COMBS];
+  SYNTH_DelayLine_t      Allpasses[SYNTH_REVERB_ALLPASSES];
+  uint32_t               ReverbTail;
+#endif
+
+  /* Counts down after the last non-zero input, 0 once every tail decayed */
+  uint32_t               Tail;
+
+  /* Taps are processed from these, never in place in the delay lines */
+  int32_t                Work[2U * SYNTH_STREAM_BLOCK_SIZE];
+  int32_t                Wet[SYNTH_STREAM_BLOCK_SIZE];
+} SYNTH_Fx_t;
+
+/**
+  * @}
+  */
+
+/** @defgroup SYNTH_Fx_Exported_Functions Synth Fx Exported Functions
+  * @{
+  */
+
+#if SYNTH_USE_FX
+int32_t SYNTH_FxSetDelay(SYNTH_Fx_t *fx, SYNTH_Pool_t *pool, const SYNTH_Delay_t *delay,
+                         uint32_t sample_rate);
+int32_t SYNTH_FxSetChorus(SYNTH_Fx_t *fx, SYNTH_Pool_t *pool, const SYNTH_Chorus_t *chorus,
+                          uint32_t sample_rate);
+int32_t SYNTH_FxSetReverb(SYNTH_Fx_t *fx, SYNTH_Pool_t *pool, const SYNTH_Reverb_t *reverb,
+                          uint32_t sample_rate);
+uint8_t SYNTH_FxActive(const SYNTH_Fx_t *fx);
+void    SYNTH_FxProcess(SYNTH_Fx_t *fx, int32_t *mix, uint32_t frames, uint32_t sample_rate);
+#endif
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYNTH_FX_H */
+
+/************************ (C) COPYRIGHT Embedded Systems Team *****END OF FILE****/
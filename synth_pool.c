@@ -0,0 +1,148 @@
+/**
+  ******************************************************************************
+  * @file    synth_pool.c
+  * @author  Cullen Sharp
+  * @brief   This file provides a fixed-block memory pool for the Synth.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2025
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "synth.h"
+#include <stddef.h>
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/** @addtogroup Components
+  * @{
+  */
+
+/** @addtogroup Synth
+  * @{
+  */
+
+/** @defgroup SYNTH_Pool_Exported_Functions Synth Pool Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Carve caller provided memory into equal blocks
+  * @note   The memory decides the placement, e.g. a DTCM array for hot
+  *         state or an AXI SRAM/SDRAM array for delay lines, see the
+  *         SYNTH_FAST_RAM and SYNTH_BULK_RAM hooks in synth_conf.h.
+  * @param  pool        Pointer to pool
+  * @param  memory      Backing memory, SYNTH_POOL_ALIGN aligned
+  * @param  size        Size of memory in bytes
+  * @param  block_size  Bytes per block, rounded up to SYNTH_POOL_ALIGN
+  * @retval Synth status
+  */
+int32_t SYNTH_PoolInit(SYNTH_Pool_t *pool, void *memory, uint32_t size, uint32_t block_size)
+{
+  uint8_t  *block = (uint8_t *)memory;
+  uint32_t i;
+
+  if ((pool == NULL) || (memory == NULL) || (block_size == 0U) ||
+      (((uintptr_t)memory & (SYNTH_POOL_ALIGN - 1U)) != 0U))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  block_size = (block_size + SYNTH_POOL_ALIGN - 1U) & ~(SYNTH_POOL_ALIGN - 1U);
+
+  pool->Base       = block;
+  pool->BlockSize  = block_size;
+  pool->BlockCount = size / block_size;
+  pool->FreeCount  = pool->BlockCount;
+  pool->FreeList   = (pool->BlockCount != 0U) ? block : NULL;
+
+  for (i = 0; i < pool->BlockCount; i++)
+  {
+    *(void **)block = ((i + 1U) < pool->BlockCount) ? (block + block_size) : NULL;
+    block += block_size;
+  }
+
+  return (pool->BlockCount != 0U) ? SYNTH_STATUS_OK : SYNTH_STATUS_ERROR;
+}
+
+/**
+  * @brief  Take one block from the pool
+  * @note   Not reentrant, allocate and release from a single context.
+  * @param  pool  Pointer to pool
+  * @retval Block address, NULL when the pool is exhausted
+  */
+void *SYNTH_PoolAlloc(SYNTH_Pool_t *pool)
+{
+  void *block = pool->FreeList;
+
+  if (block != NULL)
+  {
+    pool->FreeList = *(void **)block;
+    pool->FreeCount--;
+  }
+
+  return block;
+}
+
+/**
+  * @brief  Return a block to the pool
+  * @param  pool   Pointer to pool
+  * @param  block  Block obtained from SYNTH_PoolAlloc on the same pool
+  * @retval Synth status, error for an address outside the pool
+  */
+int32_t SYNTH_PoolFree(SYNTH_Pool_t *pool, void *block)
+{
+  uintptr_t offset = (uintptr_t)block - (uintptr_t)pool->Base;
+
+  if ((block == NULL) ||
+      (offset >= ((uintptr_t)pool->BlockSize * pool->BlockCount)) ||
+      ((offset % pool->BlockSize) != 0U))
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  *(void **)block = pool->FreeList;
+  pool->FreeList  = block;
+  pool->FreeCount++;
+
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Get the number of free blocks
+  * @param  pool  Pointer to pool
+  * @retval Free block count
+  */
+uint32_t SYNTH_PoolGetFree(const SYNTH_Pool_t *pool)
+{
+  return pool->FreeCount;
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Embedded Systems Team *****END OF FILE****/
@@ -0,0 +1,108 @@
+/**
+  ******************************************************************************
+  * @file    synth_pool.h
+  * @author  Cullen Sharp
+  * @brief   This file contains the fixed-block memory pool definitions.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2025
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef SYNTH_POOL_H
+#define SYNTH_POOL_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/** @addtogroup Components
+  * @{
+  */
+
+/** @addtogroup Synth
+  * @{
+  */
+
+/** @defgroup SYNTH_Pool_Exported_Constants Synth Pool Exported Constants
+  * @{
+  */
+
+/* Block sizes are rounded up to this, enough for any scalar and for the
+   free list link stored in unused blocks */
+#define SYNTH_POOL_ALIGN            8U
+
+/**
+  * @}
+  */
+
+/** @defgroup SYNTH_Pool_Exported_Types Synth Pool Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Fixed-block pool over caller provided memory
+  * @note   Free blocks form a singly linked list threaded through their
+  *         first word, so allocation and release are O(1) with no header.
+  */
+typedef struct
+{
+  void     *FreeList;
+  uint8_t  *Base;
+  uint32_t BlockSize;    /*!< Bytes per block, multiple of SYNTH_POOL_ALIGN */
+  uint32_t BlockCount;
+  uint32_t FreeCount;
+} SYNTH_Pool_t;
+
+/**
+  * @}
+  */
+
+/** @defgroup SYNTH_Pool_Exported_Functions Synth Pool Exported Functions
+  * @{
+  */
+
+int32_t  SYNTH_PoolInit(SYNTH_Pool_t *pool, void *memory, uint32_t size, uint32_t block_size);
+void    *SYNTH_PoolAlloc(SYNTH_Pool_t *pool);
+int32_t  SYNTH_PoolFree(SYNTH_Pool_t *pool, void *block);
+uint32_t SYNTH_PoolGetFree(const SYNTH_Pool_t *pool);
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYNTH_POOL_H */
+
+/************************ (C) COPYRIGHT Embedded Systems Team *****END OF FILE****/
@@ -0,0 +1,199 @@
+/**
+  ******************************************************************************
+  * @file    synth_rtos.c
+  * @author  Cullen Sharp
+  * @brief   This file provides the FreeRTOS render task glue for the Synth.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2025
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "synth.h"
+
+#if (SYNTH_USE_RTOS == 1U)
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/** @addtogroup Components
+  * @{
+  */
+
+/** @addtogroup Synth
+  * @{
+  */
+
+/** @defgroup SYNTH_Rtos_Exported_Functions Synth Rtos Exported Functions
+  * @{
+  */
+
+/**
+  * @brief  Create the render task and its command queue
+  * @note   Both are statically allocated inside rtos, which needs
+  *         configSUPPORT_STATIC_ALLOCATION. The task runs at
+  *         SYNTH_RTOS_PRIORITY, above every task that posts to it.
+  * @param  rtos   Pointer to render task state
+  * @param  entry  Task function
+  * @param  arg    Task argument
+  * @retval Synth status
+  */
+int32_t SYNTH_RtosCreate(SYNTH_Rtos_t *rtos, TaskFunction_t entry, void *arg)
+{
+  rtos->Released = 0;
+  rtos->Queue = xQueueCreateStatic(SYNTH_RTOS_QUEUE_LENGTH, sizeof(SYNTH_Command_t),
+                                   rtos->QueueStorage, &rtos->QueueBuffer);
+  if (rtos->Queue == NULL)
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  rtos->Task = xTaskCreateStatic(entry, "synth", SYNTH_RTOS_STACK_SIZE, arg,
+                                 SYNTH_RTOS_PRIORITY, rtos->Stack, &rtos->TaskBuffer);
+  if (rtos->Task == NULL)
+  {
+    vQueueDelete(rtos->Queue);
+    rtos->Queue = NULL;
+    return SYNTH_STATUS_ERROR;
+  }
+
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Delete the render task and its command queue
+  * @note   Must not be called from the render task itself.
+  * @param  rtos  Pointer to render task state
+  * @retval None
+  */
+void SYNTH_RtosDelete(SYNTH_Rtos_t *rtos)
+{
+  if (rtos->Task != NULL)
+  {
+    vTaskDelete(rtos->Task);
+    rtos->Task = NULL;
+  }
+
+  if (rtos->Queue != NULL)
+  {
+    vQueueDelete(rtos->Queue);
+    rtos->Queue = NULL;
+  }
+}
+
+/**
+  * @brief  Queue a command for the render task
+  * @param  rtos     Pointer to render task state
+  * @param  command  Pointer to command, copied
+  * @param  timeout  Ticks to wait for a free entry, 0 to return at once
+  * @retval Synth status, SYNTH_STATUS_BUSY when the queue stayed full
+  */
+int32_t SYNTH_RtosPost(SYNTH_Rtos_t *rtos, const SYNTH_Command_t *command, uint32_t timeout)
+{
+  if (rtos->Queue == NULL)
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  if (xQueueSend(rtos->Queue, command, (TickType_t)timeout) != pdPASS)
+  {
+    return SYNTH_STATUS_BUSY;
+  }
+
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Take the oldest queued command, without blocking
+  * @param  rtos     Pointer to render task state
+  * @param  command  Pointer to return the command
+  * @retval Synth status, SYNTH_STATUS_BUSY when the queue is empty
+  */
+int32_t SYNTH_RtosReceive(SYNTH_Rtos_t *rtos, SYNTH_Command_t *command)
+{
+  if (rtos->Queue == NULL)
+  {
+    return SYNTH_STATUS_ERROR;
+  }
+
+  if (xQueueReceive(rtos->Queue, command, 0) != pdPASS)
+  {
+    return SYNTH_STATUS_BUSY;
+  }
+
+  return SYNTH_STATUS_OK;
+}
+
+/**
+  * @brief  Block the render task until the next notification
+  * @note   Notifications given while the task was busy are merged into one
+  *         wake, the task then serves every free half.
+  * @param  rtos  Pointer to render task state
+  * @retval None
+  */
+void SYNTH_RtosWait(SYNTH_Rtos_t *rtos)
+{
+  (void)rtos;
+  (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+/**
+  * @brief  Wake the render task from another task
+  * @param  rtos  Pointer to render task state
+  * @retval None
+  */
+void SYNTH_RtosNotify(SYNTH_Rtos_t *rtos)
+{
+  if (rtos->Task != NULL)
+  {
+    xTaskNotifyGive(rtos->Task);
+  }
+}
+
+/**
+  * @brief  Wake the render task from the DMA interrupt
+  * @note   Switches to it on interrupt exit when it outranks the task that
+  *         was interrupted.
+  * @param  rtos  Pointer to render task state
+  * @retval None
+  */
+void SYNTH_RtosNotifyFromISR(SYNTH_Rtos_t *rtos)
+{
+  BaseType_t woken = pdFALSE;
+
+  if (rtos->Task != NULL)
+  {
+    vTaskNotifyGiveFromISR(rtos->Task, &woken);
+    portYIELD_FROM_ISR(woken);
+  }
+}
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#endif /* SYNTH_USE_RTOS */
+
+/************************ (C) COPYRIGHT Embedded Systems Team *****END OF FILE****/
@@ -0,0 +1,141 @@
+/**
+  ******************************************************************************
+  * @file    synth_rtos.h
+  * @author  Cullen Sharp
+  * @brief   This file contains the FreeRTOS render task definitions.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2025
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef SYNTH_RTOS_H
+#define SYNTH_RTOS_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "synth_conf.h"
+
+#if (SYNTH_USE_RTOS == 1U)
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#endif
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/** @addtogroup Components
+  * @{
+  */
+
+/** @addtogroup Synth
+  * @{
+  */
+
+/** @defgroup SYNTH_Rtos_Exported_Constants Synth Rtos Exported Constants
+  * @{
+  */
+
+/* Render task commands, see SYNTH_Command_t */
+#define SYNTH_CMD_NOTE_ON           0U   /*!< Note, Value velocity            */
+#define SYNTH_CMD_NOTE_OFF          1U   /*!< Note                            */
+#define SYNTH_CMD_VOLUME            2U   /*!< Value 0-100                     */
+#define SYNTH_CMD_MUTE              3U   /*!< Value 0/1                       */
+#define SYNTH_CMD_WAVEFORM          4U   /*!< Value waveform id               */
+#define SYNTH_CMD_PLAY_BUFFER       5U   /*!< Data, Length, Value volume      */
+#define SYNTH_CMD_PRESET            6U   /*!< Data, Length bytes              */
+#define SYNTH_CMD_START             7U   /*!< Restart the stream              */
+#define SYNTH_CMD_STOP              8U   /*!< Stop the stream                 */
+
+/**
+  * @}
+  */
+
+/** @defgroup SYNTH_Rtos_Exported_Types Synth Rtos Exported Types
+  * @{
+  */
+
+/**
+  * @brief  Request from another task, applied by the render task
+  */
+typedef struct
+{
+  uint8_t    Type;      /*!< SYNTH_CMD_xxx                                 */
+  uint8_t    Note;
+  uint8_t    Value;
+  const void *Data;
+  uint32_t   Length;
+} SYNTH_Command_t;
+
+#if (SYNTH_USE_RTOS == 1U)
+/**
+  * @brief  Render task and command queue, statically allocated
+  */
+typedef struct
+{
+  TaskHandle_t           Task;
+  QueueHandle_t          Queue;
+  volatile uint32_t      Released;      /*!< Cycle count of the last DMA release */
+  StaticTask_t           TaskBuffer;
+  StaticQueue_t          QueueBuffer;
+  StackType_t            Stack[SYNTH_RTOS_STACK_SIZE];
+  uint8_t                QueueStorage[SYNTH_RTOS_QUEUE_LENGTH * sizeof(SYNTH_Command_t)];
+} SYNTH_Rtos_t;
+#endif
+
+/**
+  * @}
+  */
+
+/** @defgroup SYNTH_Rtos_Exported_Functions Synth Rtos Exported Functions
+  * @{
+  */
+
+#if (SYNTH_USE_RTOS == 1U)
+int32_t SYNTH_RtosCreate(SYNTH_Rtos_t *rtos, TaskFunction_t entry, void *arg);
+void    SYNTH_RtosDelete(SYNTH_Rtos_t *rtos);
+int32_t SYNTH_RtosPost(SYNTH_Rtos_t *rtos, const SYNTH_Command_t *command, uint32_t timeout);
+int32_t SYNTH_RtosReceive(SYNTH_Rtos_t *rtos, SYNTH_Command_t *command);
+void    SYNTH_RtosWait(SYNTH_Rtos_t *rtos);
+void    SYNTH_RtosNotify(SYNTH_Rtos_t *rtos);
+void    SYNTH_RtosNotifyFromISR(SYNTH_Rtos_t *rtos);
+#endif
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYNTH_RTOS_H */
+
+/************************ (C) COPYRIGHT Embedded Systems Team *****END OF FILE****/
@@ -0,0 +1,206 @@
+/**
+  ******************************************************************************
+  * @file    synth_wavetable.c
+  * @author  Cullen Sharp
+  * @brief   This file provides the Synth oscillator wavetables.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2025
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "synth_wavetable.h"
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/** @addtogroup Components
+  * @{
+  */
+
+/** @addtogroup Synth
+  * @{
+  */
+
+/* Exported constants --------------------------------------------------------*/
+/* Tables are const so the linker keeps them in flash */
+
+/**
+  * @brief  One period of sine
+  */
+const int16_t SYNTH_SineTable[SYNTH_WAVETABLE_SIZE] =
+{
+       0,    804,   1608,   2410,   3212,   4011,   4808,   5602,
+    6393,   7179,   7962,   8739,   9512,  10278,  11039,  11793,
+   12539,  13279,  14010,  14732,  15446,  16151,  16846,  17530,
+   18204,  18868,  19519,  20159,  20787,  21403,  22005,  22594,
+   23170,  23731,  24279,  24811,  25329,  25832,  26319,  26790,
+   27245,  27683,  28105,  28510,  28898,  29268,  29621,  29956,
+   30273,  30571,  30852,  31113,  31356,  31580,  31785,  31971,
+   32137,  32285,  32412,  32521,  32609,  32678,  32728,  32757,
+   32767,  32757,  32728,  32678,  32609,  32521,  32412,  32285,
+   32137,  31971,  31785,  31580,  31356,  31113,  30852,  30571,
+   30273,  29956,  29621,  29268,  28898,  28510,  28105,  27683,
+   27245,  26790,  26319,  25832,  25329,  24811,  24279,  23731,
+   23170,  22594,  22005,  21403,  20787,  20159,  19519,  18868,
+   18204,  17530,  16846,  16151,  15446,  14732,  14010,  13279,
+   12539,  11793,  11039,  10278,   9512,   8739,   7962,   7179,
+    6393,   5602,   4808,   4011,   3212,   2410,   1608,    804,
+       0,   -804,  -1608,  -2410,  -3212,  -4011,  -4808,  -5602,
+   -6393,  -7179,  -7962,  -8739,  -9512, -10278, -11039, -11793,
+  -12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530,
+  -18204, -18868, -19519, -20159, -20787, -21403, -22005, -22594,
+  -23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790,
+  -27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956,
+  -30273, -30571, -30852, -31113, -31356, -31580, -31785, -31971,
+  -32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757,
+  -32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285,
+  -32137, -31971, -31785, -31580, -31356, -31113, -30852, -30571,
+  -30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683,
+  -27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731,
+  -23170, -22594, -22005, -21403, -20787, -20159, -19519, -18868,
+  -18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279,
+  -12539, -11793, -11039, -10278,  -9512,  -8739,  -7962,  -7179,
+   -6393,  -5602,  -4808,  -4011,  -3212,  -2410,  -1608,   -804
+};
+
+/**
+  * @brief  One period of square, 50% duty
+  */
+const int16_t SYNTH_SquareTable[SYNTH_WAVETABLE_SIZE] =
+{
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+   32767,  32767,  32767,  32767,  32767,  32767,  32767,  32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767,
+  -32767, -32767, -32767, -32767, -32767, -32767, -32767, -32767
+};
+
+/**
+  * @brief  One period of rising sawtooth
+  */
+const int16_t SYNTH_SawTable[SYNTH_WAVETABLE_SIZE] =
+{
+  -32768, -32512, -32256, -32000, -31744, -31488, -31232, -30976,
+  -30720, -30464, -30208, -29952, -29696, -29440, -29184, -28928,
+  -28672, -28416, -28160, -27904, -27648, -27392, -27136, -26880,
+  -26624, -26368, -26112, -25856, -25600, -25344, -25088, -24832,
+  -24576, -24320, -24064, -23808, -23552, -23296, -23040, -22784,
+  -22528, -22272, -22016, -21760, -21504, -21248, -20992, -20736,
+  -20480, -20224, -19968, -19712, -19456, -19200, -18944, -18688,
+  -18432, -18176, -17920, -17664, -17408, -17152, -16896, -16640,
+  -16384, -16128, -15872, -15616, -15360, -15104, -14848, -14592,
+  -14336, -14080, -13824, -13568, -13312, -13056, -12800, -12544,
+  -12288, -12032, -11776, -11520, -11264, -11008, -10752, -10496,
+  -10240,  -9984,  -9728,  -9472,  -9216,  -8960,  -8704,  -8448,
+   -8192,  -7936,  -7680,  -7424,  -7168,  -6912,  -6656,  -6400,
+   -6144,  -5888,  -5632,  -5376,  -5120,  -4864,  -4608,  -4352,
+   -4096,  -3840,  -3584,  -3328,  -3072,  -2816,  -2560,  -2304,
+   -2048,  -1792,  -1536,  -1280,  -1024,   -768,   -512,   -256,
+       0,    256,    512,    768,   1024,   1280,   1536,   1792,
+    2048,   2304,   2560,   2816,   3072,   3328,   3584,   3840,
+    4096,   4352,   4608,   4864,   5120,   5376,   5632,   5888,
+    6144,   6400,   6656,   6912,   7168,   7424,   7680,   7936,
+    8192,   8448,   8704,   8960,   9216,   9472,   9728,   9984,
+   10240,  10496,  10752,  11008,  11264,  11520,  11776,  12032,
+   12288,  12544,  12800,  13056,  13312,  13568,  13824,  14080,
+   14336,  14592,  14848,  15104,  15360,  15616,  15872,  16128,
+   16384,  16640,  16896,  17152,  17408,  17664,  17920,  18176,
+   18432,  18688,  18944,  19200,  19456,  19712,  19968,  20224,
+   20480,  20736,  20992,  21248,  21504,  21760,  22016,  22272,
+   22528,  22784,  23040,  23296,  23552,  23808,  24064,  24320,
+   24576,  24832,  25088,  25344,  25600,  25856,  26112,  26368,
+   26624,  26880,  27136,  27392,  27648,  27904,  28160,  28416,
+   28672,  28928,  29184,  29440,  29696,  29952,  30208,  30464,
+   30720,  30976,  31232,  31488,  31744,  32000,  32256,  32512
+};
+
+/**
+  * @brief  One period of triangle
+  */
+const int16_t SYNTH_TriangleTable[SYNTH_WAVETABLE_SIZE] =
+{
+       0,    512,   1024,   1536,   2048,   2560,   3072,   3584,
+    4096,   4608,   5120,   5632,   6144,   6656,   7168,   7680,
+    8192,   8704,   9216,   9728,  10240,  10752,  11264,  11776,
+   12288,  12800,  13312,  13824,  14336,  14848,  15360,  15872,
+   16384,  16895,  17407,  17919,  18431,  18943,  19455,  19967,
+   20479,  20991,  21503,  22015,  22527,  23039,  23551,  24063,
+   24575,  25087,  25599,  26111,  26623,  27135,  27647,  28159,
+   28671,  29183,  29695,  30207,  30719,  31231,  31743,  32255,
+   32767,  32255,  31743,  31231,  30719,  30207,  29695,  29183,
+   28671,  28159,  27647,  27135,  26623,  26111,  25599,  25087,
+   24575,  24063,  23551,  23039,  22527,  22015,  21503,  20991,
+   20479,  19967,  19455,  18943,  18431,  17919,  17407,  16895,
+   16384,  15872,  15360,  14848,  14336,  13824,  13312,  12800,
+   12288,  11776,  11264,  10752,  10240,   9728,   9216,   8704,
+    8192,   7680,   7168,   6656,   6144,   5632,   5120,   4608,
+    4096,   3584,   3072,   2560,   2048,   1536,   1024,    512,
+       0,   -512,  -1024,  -1536,  -2048,  -2560,  -3072,  -3584,
+   -4096,  -4608,  -5120,  -5632,  -6144,  -6656,  -7168,  -7680,
+   -8192,  -8704,  -9216,  -9728, -10240, -10752, -11264, -11776,
+  -12288, -12800, -13312, -13824, -14336, -14848, -15360, -15872,
+  -16384, -16895, -17407, -17919, -18431, -18943, -19455, -19967,
+  -20479, -20991, -21503, -22015, -22527, -23039, -23551, -24063,
+  -24575, -25087, -25599, -26111, -26623, -27135, -27647, -28159,
+  -28671, -29183, -29695, -30207, -30719, -31231, -31743, -32255,
+  -32767, -32255, -31743, -31231, -30719, -30207, -29695, -29183,
+  -28671, -28159, -27647, -27135, -26623, -26111, -25599, -25087,
+  -24575, -24063, -23551, -23039, -22527, -22015, -21503, -20991,
+  -20479, -19967, -19455, -18943, -18431, -17919, -17407, -16895,
+  -16384, -15872, -15360, -14848, -14336, -13824, -13312, -12800,
+  -12288, -11776, -11264, -10752, -10240,  -9728,  -9216,  -8704,
+   -8192,  -7680,  -7168,  -6656,  -6144,  -5632,  -5120,  -4608,
+   -4096,  -3584,  -3072,  -2560,  -2048,  -1536,  -1024,   -512
+};
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT Embedded Systems Team *****END OF FILE****/
@@ -0,0 +1,74 @@
+/**
+  ******************************************************************************
+  * @file    synth_wavetable.h
+  * @author  Cullen Sharp
+  * @brief   This file contains the built-in oscillator wavetables.
+  ******************************************************************************
+  * @attention
+  *
+  * <h2><center>&copy; Copyright (c) 2025
+  * All rights reserved.</center></h2>
+  *
+  * This software component is licensed under BSD 3-Clause license,
+  * the "License"; You may not use this file except in compliance with the
+  * License. You may obtain a copy of the License at:
+  *                        opensource.org/licenses/BSD-3-Clause
+  *
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef SYNTH_WAVETABLE_H
+#define SYNTH_WAVETABLE_H
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "synth.h"
+
+/** @addtogroup BSP
+  * @{
+  */
+
+/** @addtogroup Components
+  * @{
+  */
+
+/** @addtogroup Synth
+  * @{
+  */
+
+/** @defgroup SYNTH_Wavetable_Exported_Constants Synth Wavetable Exported Constants
+  * @{
+  */
+
+extern const int16_t SYNTH_SineTable[SYNTH_WAVETABLE_SIZE];
+extern const int16_t SYNTH_SquareTable[SYNTH_WAVETABLE_SIZE];
+extern const int16_t SYNTH_SawTable[SYNTH_WAVETABLE_SIZE];
+extern const int16_t SYNTH_TriangleTable[SYNTH_WAVETABLE_SIZE];
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SYNTH_WAVETABLE_H */
+
+/************************ (C) COPYRIGHT Embedded Systems Team *****END OF FILE****/